@@ -0,0 +1,68 @@
+/* Clearing around a region that has to stay, both ways uc1698u_fill_outside_64K
+ * can do it, timed. Same setup as WriteImage. */
+
+#include "Arduino.h"
+#include <uc1698u.h>
+#include <uc1698u_gfx.h>
+
+/* kept region, pixels */
+#define KEEP_X 48
+#define KEEP_Y 56
+#define KEEP_W 63
+#define KEEP_H 48
+
+struct uc1698u_config config = {
+	.pin = {
+		.CS = 10,
+		.CD = 11,
+		.WR0 = 13,
+		.WR1 = 12,
+		.DX = {9, 8, 7, 6, 5, 4, A0, A1 } /* not using pins 2, 3 because of interrupts */
+	},
+	.state = uc1698u_default_state
+};
+
+static void
+clear_timed(const char *name, uint8_t method, uint8_t val)
+{
+	unsigned long start;
+
+	start = micros();
+	uc1698u_fill_outside_64K(&config, KEEP_X, KEEP_Y, KEEP_W, KEEP_H, val, method);
+	start = micros() - start;
+
+	/* has to land inside the window again, whichever way it went */
+	uc1698u_draw_rect_64K(&config, KEEP_X - 3, KEEP_Y - 3, KEEP_W + 6, KEEP_H + 6, 31);
+
+	Serial.print(name);
+	Serial.print(": ");
+	Serial.print(start);
+	Serial.write(" us\n\r");
+}
+
+void
+setup()
+{
+	Serial.begin(115200);
+	while (!Serial) {}
+
+	uc1698u_init_pins(&config);
+	uc1698u_init_erc160160(&config);
+	uc1698u_wake_display(&config);
+
+	uc1698u_fill_rect_64K(&config, KEEP_X, KEEP_Y, KEEP_W, KEEP_H, 31);
+	uc1698u_draw_text_64K(&config, KEEP_X + 6, KEEP_Y + 20, "keep me", 0, 31);
+}
+
+void
+loop()
+{
+	/* the burst in window program outside mode runs through all 128 SRAM
+	 * columns, more than twice the bands on this 54 column window */
+	clear_timed("outside mode", UC1698U_FILL_OUTSIDE_BURST, 8);
+	delay(1000);
+	clear_timed("bands", UC1698U_FILL_OUTSIDE_BANDS, 0);
+	delay(1000);
+	clear_timed("auto", UC1698U_FILL_OUTSIDE_AUTO, 16);
+	delay(1000);
+}
@@ -0,0 +1,38 @@
+/* Frames streamed from a host with extra/stream/stream.py, same setup as WriteImage */
+
+#include "Arduino.h"
+#include <uc1698u.h>
+#include <uc1698u_stream.h>
+
+struct uc1698u_config config = {
+	.pin = {
+		.CS = 10,
+		.CD = 11,
+		.WR0 = 13,
+		.WR1 = 12,
+		.DX = {9, 8, 7, 6, 5, 4, A0, A1 } /* not using pins 2, 3 because of interrupts */
+	},
+	.state = uc1698u_default_state
+};
+
+struct uc1698u_stream stream;
+
+void
+setup()
+{
+	Serial.begin(115200);
+	while (!Serial) {}
+
+	uc1698u_init_pins(&config);
+	uc1698u_init_erc160160(&config);
+	uc1698u_wake_display(&config);
+
+	/* nothing else may be written to Serial from here on */
+	uc1698u_stream_init(&config, &stream);
+}
+
+void
+loop()
+{
+	uc1698u_stream_poll(&config, &stream, &Serial);
+}
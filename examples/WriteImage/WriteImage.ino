@@ -2,6 +2,7 @@
 
 #include "Arduino.h"
 #include <uc1698u.h>
+#include <uc1698u_profile.h>
 #include <avr/pgmspace.h>
 
 #include "img.h"
@@ -34,6 +35,13 @@ setup()
 
 	uc1698u_wake_display(&config);
 	Serial.write("Display wake done!\n\r");
+
+	Serial.print("Boot to first frame: ");
+	Serial.print(millis());
+	Serial.write(" ms\n\r");
+
+	/* only prints when built with -DUC1698U_PROFILE=1 */
+	uc1698u_profile_report();
 }
 
 void
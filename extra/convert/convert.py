@@ -1,39 +1,236 @@
-import sys, cv2, os
+import sys, cv2, os, re
+import numpy as np
 
 lcd_size = (160, 160)
 level_width = 256 / 32
+span_gap = 2 # unchanged tripixels bridged instead of starting a new span
+image_exts = (".png", ".bmp", ".jpg", ".jpeg", ".gif", ".tif", ".tiff", ".pgm")
 
-def adjustImageDepth(img):
-    img = cv2.resize(img, lcd_size)
-    for x in range(lcd_size[0]):
-        for y in range(lcd_size[1]):
-            img[y,x] = int(img[y,x] / level_width) * level_width
-    return img
-
-def convertImagetoCode(img):
-    code = "const uint8_t img[] PROGMEM = { "
-    for y in range(lcd_size[1]):
-        for x in range(lcd_size[0]):
-            # invert since LOW is black (LED ON) and HIGH is white (LED OFF)
-            code += str(31 - int(img[y,x] / level_width)) + ", "
-    code += "};\n"
+# 8x8 bayer matrix, thresholds in [0, 1)
+bayer = np.array([[0]])
+for i in range(3):
+    bayer = np.block([[4 * bayer, 4 * bayer + 2], [4 * bayer + 3, 4 * bayer + 1]])
+bayer = (bayer + 0.5) / bayer.size
+
+def quantiseNone(img):
+    # plain truncation to level_width bands
+    return (img // level_width).astype(np.uint8)
+
+def quantiseOrdered(img):
+    h, w = img.shape
+    threshold = np.tile(bayer, (h // 8 + 1, w // 8 + 1))[:h, :w]
+    return np.clip(np.floor(img * 31.0 / 255 + threshold), 0, 31).astype(np.uint8)
+
+def quantiseFloydSteinberg(img):
+    # pixels on the same x + 2y wavefront do not depend on each other,
+    # so each wavefront is quantised and diffused in one go
+    h, w = img.shape
+    buf = np.zeros((h + 1, w + 2))
+    buf[:h, 1:w+1] = img * 31.0 / 255
+    levels = np.zeros((h, w), np.uint8)
+    ys = np.arange(h)
+    for t in range(w + 2 * (h - 1)):
+        xs = t - 2 * ys
+        valid = (xs >= 0) & (xs < w)
+        y, x = ys[valid], xs[valid] + 1
+        level = np.clip(np.round(buf[y, x]), 0, 31)
+        err = buf[y, x] - level
+        levels[y, x - 1] = level
+        np.add.at(buf, (y, x + 1), err * 7 / 16)
+        np.add.at(buf, (y + 1, x - 1), err * 3 / 16)
+        np.add.at(buf, (y + 1, x), err * 5 / 16)
+        np.add.at(buf, (y + 1, x + 1), err * 1 / 16)
+    return levels
+
+quantisers = {"none": quantiseNone, "ordered": quantiseOrdered, "fs": quantiseFloydSteinberg}
+
+def scaleImage(img, size=lcd_size):
+    img = cv2.normalize(img, None, 0, 255, cv2.NORM_MINMAX)
+    return cv2.resize(img, size)
+
+def loadImage(path, size=lcd_size):
+    img = cv2.imread(path, cv2.IMREAD_GRAYSCALE)
+    if img is None:
+        return None
+    return scaleImage(img, size)
+
+def fitSize(shape):
+    # native size, scaled down to fit the panel
+    h, w = shape
+    scale = min(1.0, float(lcd_size[0]) / w, float(lcd_size[1]) / h)
+    return max(1, int(w * scale)), max(1, int(h * scale))
+
+def toShades(levels):
+    # invert since LOW is black (LED ON) and HIGH is white (LED OFF)
+    return 31 - levels
+
+def toPreview(levels):
+    return (levels * level_width).astype(np.uint8)
+
+def padTripix(shades):
+    # rows padded with shade 0 to whole tripixels
+    h, w = shades.shape
+    pad = np.zeros((h, (w + 2) // 3 * 3), np.uint8)
+    pad[:, :w] = shades
+    return pad
+
+def encodeTripix(shades):
+    # same as uc1698u_64k_encode
+    pad = padTripix(shades)
+    a, b, c = pad[:, 0::3], pad[:, 1::3], pad[:, 2::3]
+    tripix = np.empty((pad.shape[0], pad.shape[1] // 3, 2), np.uint8)
+    tripix[:, :, 0] = ((a & 31) << 3) | ((b >> 2) & 7)
+    tripix[:, :, 1] = ((b & 3) << 6) | (c & 31)
+    return tripix
+
+def arrayCode(name, data):
+    return "const uint8_t {}[] PROGMEM = {{ {}, }};\n".format(name, ", ".join(map(str, np.ravel(data))))
+
+def convertImagetoCode(levels):
+    return arrayCode("img", toShades(levels))
+
+def frameDelta(prev, cur):
+    # changed tripixel runs per row, merged into rects over consecutive rows
+    diff = (prev != cur).any(axis=2)
+    rects, open_rects = [], {}
+    for y in range(cur.shape[0]):
+        runs = []
+        for x in np.flatnonzero(diff[y]):
+            if runs and x - runs[-1][1] - 1 <= span_gap:
+                runs[-1][1] = x
+            else:
+                runs.append([x, x])
+
+        next_open = {}
+        for start, last in runs:
+            rect = open_rects.get((start, last))
+            if rect is None:
+                rect = [int(start), y, int(last - start + 1), 0]
+                rects.append(rect)
+            rect[3] += 1
+            next_open[(start, last)] = rect
+        open_rects = next_open
+
+    data = bytearray((len(rects) & 0xff, len(rects) >> 8))
+    for col, row, width, height in rects:
+        data += bytes((col, row, width, height))
+        data += cur[row:row+height, col:col+width].tobytes()
+    return data
+
+def convertAnimtoCode(name, frames, loop):
+    # first frame is a delta against the cleared screen after init
+    blank = encodeTripix(np.zeros((lcd_size[1], lcd_size[0]), np.uint8))
+    seq = frames + [frames[0]] if loop and len(frames) > 1 else frames
+    data = bytearray((len(seq) & 0xff, len(seq) >> 8))
+    data += bytes((1, 0) if loop and len(frames) > 1 else (0xff, 0xff))
+    prev = blank
+    for cur in seq:
+        data += frameDelta(prev, cur)
+        prev = cur
+    code = "const uint8_t {}[] PROGMEM = {{ ".format(name)
+    code += ", ".join(str(b) for b in data)
+    code += " };\n"
+    return code, len(data)
+
+def convertAssettoCode(name, levels):
+    # every lib/ format of one asset: shades for uc1698u_write_image_64K and
+    # uc1698u_asset, tripixels for uc1698u_write_packed_64K; the first two
+    # read whole tripixels too, so all of them are padded to a multiple of 3
+    h, w = levels.shape
+    shades = padTripix(toShades(levels))
+    code = "#include <uc1698u_gfx.h>\n\n"
+    if shades.shape[1] == w:
+        code += "/* {}x{} */\n".format(w, h)
+    else:
+        code += "/* {}x{}, padded to {}x{} */\n".format(w, h, shades.shape[1], h)
+    code += arrayCode(name, shades)
+    code += "const struct uc1698u_asset {}_asset = {{ {}, {}, {} }};\n".format(name, name, shades.shape[1], h)
+    code += arrayCode(name + "_packed", encodeTripix(shades))
     return code
 
-if len(sys.argv) < 2:
-    print("Usage: convert.py <image>")
+def identifier(path):
+    name = re.sub(r"\W", "_", os.path.splitext(os.path.basename(path))[0])
+    return "_" + name if name[:1].isdigit() else name
+
+def convertDir(path, quantise, anim, loop):
+    paths = sorted(os.path.join(path, f) for f in os.listdir(path) if f.lower().endswith(image_exts))
+    frames = []
+    for p in paths:
+        img = cv2.imread(p, cv2.IMREAD_GRAYSCALE)
+        if img is None:
+            print("Skipping {}, not an image".format(p))
+            continue
+        name = identifier(p)
+        levels = quantise(scaleImage(img, fitSize(img.shape)))
+        with open("out/{}.h".format(name), "w+") as f:
+            f.write(convertAssettoCode(name, levels))
+        cv2.imwrite("out/{}.new.bmp".format(name), toPreview(levels))
+        print("{} -> out/{}.h ({}x{})".format(p, name, levels.shape[1], levels.shape[0]))
+        if anim:
+            frames.append(encodeTripix(toShades(quantise(scaleImage(img)))))
+
+    if anim and frames:
+        name = identifier(os.path.normpath(path)) + "_anim"
+        code, size = convertAnimtoCode(name, frames, loop)
+        with open("out/{}.h".format(name), "w+") as f:
+            f.write(code)
+        print("{} frames ({} bytes) -> out/{}.h".format(len(frames), size, name))
+
+def usage():
+    print("Usage: convert.py [--dither none|ordered|fs] <image>")
+    print("       convert.py [--dither none|ordered|fs] --anim [--loop] <name> <frame>...")
+    print("       convert.py [--dither none|ordered|fs] --batch [--anim [--loop]] <dir>")
+    print("Ordered dithering is stable between frames, use it for animations.")
     sys.exit(1)
 
+args = sys.argv[1:]
+quantise = quantiseNone
+if args[:1] == ["--dither"]:
+    if len(args) < 2 or args[1] not in quantisers:
+        usage()
+    quantise = quantisers[args[1]]
+    args = args[2:]
+
+if len(args) < 1:
+    usage()
+
 if not os.path.exists("convert.py"):
     print("Run from same directory as script!")
     sys.exit(1)
 
-img = cv2.imread(sys.argv[1], cv2.IMREAD_GRAYSCALE)
-img = cv2.normalize(img, None, 0, 255, cv2.NORM_MINMAX)
-img = adjustImageDepth(img)
-reppath = "out/" + os.path.splitext(os.path.basename(sys.argv[1]))[0] + ".new.bmp"
-saved = cv2.imwrite(reppath, img)
+if args[0] == "--batch":
+    args = args[1:]
+    anim = args[:1] == ["--anim"]
+    if anim:
+        args = args[1:]
+    loop = anim and args[:1] == ["--loop"]
+    if loop:
+        args = args[1:]
+    if len(args) != 1 or not os.path.isdir(args[0]):
+        usage()
+    convertDir(args[0], quantise, anim, loop)
+    sys.exit(0)
+
+if args[0] == "--anim":
+    args = args[1:]
+    loop = len(args) > 0 and args[0] == "--loop"
+    if loop:
+        args = args[1:]
+    if len(args) < 2:
+        usage()
+    name, paths = args[0], args[1:]
+    frames = [encodeTripix(toShades(quantise(loadImage(path)))) for path in paths]
+    code, size = convertAnimtoCode(name, frames, loop)
+    with open("out/{}.h".format(name), "w+") as f:
+        f.write(code)
+    print("Done! {} frames ({} bytes) were saved to out/{}.h.".format(len(frames), size, name))
+    sys.exit(0)
+
+levels = quantise(loadImage(args[0]))
+reppath = "out/" + os.path.splitext(os.path.basename(args[0]))[0] + ".new.bmp"
+saved = cv2.imwrite(reppath, toPreview(levels))
 with open("out/img.h", "w+") as f:
-    f.write(convertImagetoCode(img))
+    f.write(convertImagetoCode(levels))
 
 print("Done! The output image was saved to out/img.h.")
 if saved:
@@ -0,0 +1,36 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+/* Just enough of the Arduino core to build uc1698u.cpp and
+ * uc1698u_stream.cpp on Linux, see board.cpp */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+#define A0 14
+#define A1 15
+
+#define PROGMEM
+#define pgm_read_byte_near(p) (*(const uint8_t *) (p))
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void delay(unsigned long ms);
+unsigned long millis(void);
+unsigned long micros(void);
+
+class Stream {
+public:
+	virtual int available(void) = 0;
+	virtual int read(void) = 0;
+	virtual size_t write(uint8_t val) = 0;
+};
+
+#endif // ARDUINO_H
@@ -0,0 +1,278 @@
+/* The StreamFrames sketch on Linux: lib/uc1698u_stream.cpp fed from a
+ * pseudo-terminal, with the panel emulated behind the 8080 bus pins.
+ * Built and started by `stream.py --board`, every received frame is
+ * saved as a PGM image. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <termios.h>
+
+#include <uc1698u.h>
+#include <uc1698u_stream.h>
+
+/* Arduino serial receive buffer */
+#define RX_SIZE 64
+
+#define SRAM_COLS 128
+#define SRAM_ROWS 160
+
+struct uc1698u_config config = {
+	.pin = {
+		.CS = 10,
+		.CD = 11,
+		.WR0 = 13,
+		.WR1 = 12,
+		.DX = {9, 8, 7, 6, 5, 4, A0, A1 }
+	},
+	.state = uc1698u_default_state
+};
+
+/* panel, data writes and the address and window commands */
+
+static struct {
+	uint16_t ram[SRAM_ROWS][SRAM_COLS];
+	uint8_t pins[32], arg, hi, phase, mode;
+	uint8_t ca, ra, wpc0, wpc1, wpp0, wpp1;
+} panel;
+
+static void
+panel_reset(void)
+{
+	panel.wpc0 = panel.wpp0 = panel.mode = 0;
+	panel.wpc1 = SRAM_COLS - 1;
+	panel.wpp1 = SRAM_ROWS - 1;
+}
+
+static void
+panel_cmd(uint8_t c)
+{
+	uint8_t arg = panel.arg;
+
+	if (arg) {
+		panel.arg = 0;
+		switch (arg) {
+		case 0xf4: panel.wpc0 = c; break;
+		case 0xf5: panel.wpp0 = c; break;
+		case 0xf6: panel.wpc1 = c; break;
+		case 0xf7: panel.wpp1 = c; break;
+		}
+		return;
+	}
+
+	if ((c & 0xf0) == 0x00)
+		panel.ca = (panel.ca & 0x70) | (c & 0x0f);
+	else if ((c & 0xf0) == 0x10)
+		panel.ca = (panel.ca & 0x0f) | ((c & 0x07) << 4);
+	else if ((c & 0xf0) == 0x60)
+		panel.ra = (panel.ra & 0xf0) | (c & 0x0f);
+	else if ((c & 0xf0) == 0x70)
+		panel.ra = (panel.ra & 0x0f) | ((c & 0x0f) << 4);
+	else if ((c & 0xfe) == 0xf8)
+		panel.mode = c & 1;
+	else if (c == 0xe2)
+		panel_reset();
+	else if (c == 0x81 || c == 0x90 || c == 0xb8 || c == 0xc8 || (c >= 0xf1 && c <= 0xf7))
+		panel.arg = c; /* two byte commands */
+}
+
+static void
+panel_data(uint8_t b)
+{
+	if (!panel.phase) {
+		panel.hi = b;
+		panel.phase = 1;
+		return;
+	}
+	panel.phase = 0;
+
+	if (panel.ra < SRAM_ROWS && panel.ca < SRAM_COLS && !(panel.mode
+			&& panel.ca >= panel.wpc0 && panel.ca <= panel.wpc1
+			&& panel.ra >= panel.wpp0 && panel.ra <= panel.wpp1))
+		panel.ram[panel.ra][panel.ca] = (panel.hi << 8) | b;
+
+	/* inside mode wraps within the window, outside mode over all of SRAM */
+	panel.ca++;
+	if (!panel.mode && panel.ca > panel.wpc1) {
+		panel.ca = panel.wpc0;
+		if (++panel.ra > panel.wpp1)
+			panel.ra = panel.wpp0;
+	} else if (panel.mode && panel.ca >= SRAM_COLS) {
+		panel.ca = 0;
+		if (++panel.ra >= SRAM_ROWS)
+			panel.ra = 0;
+	}
+}
+
+static void
+panel_save(const char *path)
+{
+	uint8_t sc, sr, ec, er, t[3], k;
+	uint16_t w;
+	FILE *f;
+	int x, y;
+
+	sc = config.state.window_prog_start_col;
+	sr = config.state.window_prog_start_row;
+	ec = config.state.window_prog_end_col;
+	er = config.state.window_prog_end_row;
+
+	if (!(f = fopen(path, "wb")))
+		return;
+	fprintf(f, "P5\n%d %d\n255\n", (ec - sc + 1) * 3, er - sr + 1);
+	for (y = sr; y <= er; y++) {
+		for (x = sc; x <= ec; x++) {
+			w = panel.ram[y][x];
+			uc1698u_64k_decode(w >> 8, w & 0xff, &t[0], &t[1], &t[2]);
+			for (k = 0; k < 3; k++)
+				fputc(255 - t[k] * 8, f);
+		}
+	}
+	fclose(f);
+}
+
+/* Arduino core */
+
+void
+pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void
+digitalWrite(uint8_t pin, uint8_t val)
+{
+	uint8_t old, b, i;
+
+	old = panel.pins[pin];
+	panel.pins[pin] = val;
+
+	if (pin == config.pin.CD)
+		panel.phase = 0;
+
+	/* latch on the rising edge of WR0 while selected */
+	if (pin != config.pin.WR0 || old || !val || panel.pins[config.pin.CS])
+		return;
+
+	for (b = 0, i = 0; i < 8; i++)
+		b |= panel.pins[config.pin.DX[i]] << i;
+	if (panel.pins[config.pin.CD])
+		panel_data(b);
+	else
+		panel_cmd(b);
+}
+
+int
+digitalRead(uint8_t pin)
+{
+	return 0;
+}
+
+unsigned long
+millis(void)
+{
+	return micros() / 1000;
+}
+
+unsigned long
+micros(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000UL + ts.tv_nsec / 1000;
+}
+
+void
+delay(unsigned long ms)
+{
+	usleep(ms * 1000);
+}
+
+/* serial on the master side of a pseudo-terminal */
+
+class PtySerial : public Stream {
+public:
+	int fd;
+	uint8_t buf[4096];
+	size_t len, pos;
+	unsigned long received, consumed, credited, overruns;
+
+	int available(void)
+	{
+		ssize_t n;
+
+		if (pos == len) {
+			pos = len = 0;
+			n = ::read(fd, buf, sizeof(buf));
+			if (n > 0) {
+				len = n;
+				received += n;
+			}
+			/* what the host sent beyond the last credit has to fit */
+			if (received - credited > RX_SIZE)
+				overruns++;
+		}
+		return len - pos;
+	}
+
+	int read(void)
+	{
+		consumed++;
+		return buf[pos++];
+	}
+
+	size_t write(uint8_t val)
+	{
+		if (val == 'K' || val == 'H')
+			credited = consumed;
+		return ::write(fd, &val, 1);
+	}
+};
+
+int
+main(int argc, char **argv)
+{
+	static PtySerial serial;
+	struct uc1698u_stream stream;
+	struct termios attr;
+	struct pollfd pfd;
+	const char *path;
+	char name[64];
+	int slave;
+
+	path = argc > 1 ? argv[1] : "board.pgm";
+
+	if (openpty(&serial.fd, &slave, name, NULL, NULL) < 0) {
+		perror("openpty");
+		return 1;
+	}
+	fcntl(serial.fd, F_SETFL, O_NONBLOCK);
+	tcgetattr(slave, &attr);
+	cfmakeraw(&attr);
+	tcsetattr(slave, TCSANOW, &attr);
+
+	uc1698u_init_pins(&config);
+	uc1698u_init_erc160160(&config);
+	uc1698u_wake_display(&config);
+	uc1698u_stream_init(&config, &stream);
+
+	printf("Board on %s, frames are saved to %s\n", name, path);
+	fflush(stdout);
+
+	pfd.fd = serial.fd;
+	pfd.events = POLLIN;
+	for (;;) {
+		poll(&pfd, 1, -1);
+		if (!uc1698u_stream_poll(&config, &stream, &serial))
+			continue;
+
+		panel_save(path);
+		printf("frame %u errors %u overruns %lu\n", stream.frames, stream.errors,
+				serial.overruns);
+		fflush(stdout);
+	}
+}
@@ -0,0 +1,222 @@
+import sys, os, time, select, subprocess, termios, tty
+import numpy as np
+import cv2
+
+# protocol, see lib/uc1698u_stream.h
+SYNC = 0xa5
+CREDIT = 16
+WINDOW = 48
+RUN = 0x80
+CHUNK_MAX = 128
+
+lcd_width = 160 # pixels, the window holds a few more to fill the last tripixel
+span_gap = 2 # unchanged tripixels bridged instead of starting a new rect
+min_run = 3 # shorter runs are cheaper inside a literal chunk
+
+def openPort(path, baud=115200):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    attrs[4] = attrs[5] = getattr(termios, "B{}".format(baud))
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+def encodeFrame(img, cols, rows, width=lcd_width):
+    # grayscale image to one uint16 per tripixel (b1 << 8 | b2), same as uc1698u_64k_encode
+    img = cv2.resize(img, (width, rows), interpolation=cv2.INTER_AREA)
+    img = cv2.normalize(img, None, 0, 255, cv2.NORM_MINMAX)
+    shades = np.zeros((rows, cols * 3), np.uint16)
+    # invert since LOW is black (LED ON) and HIGH is white (LED OFF)
+    shades[:, :width] = 31 - (img >> 3)
+    a, b, c = shades[:, 0::3], shades[:, 1::3], shades[:, 2::3]
+    b1 = ((a & 31) << 3) | ((b >> 2) & 7)
+    b2 = ((b & 3) << 6) | (c & 31)
+    return (b1 << 8) | b2
+
+def changedRects(prev, cur):
+    # changed tripixel runs per row, merged into rects over consecutive rows
+    rows, cols = cur.shape
+    if prev is None:
+        return [[0, 0, cols, rows]]
+    diff = prev != cur
+    rects, open_rects = [], {}
+    for y in range(rows):
+        runs = []
+        for x in np.flatnonzero(diff[y]):
+            if runs and x - runs[-1][1] - 1 <= span_gap:
+                runs[-1][1] = x
+            else:
+                runs.append([x, x])
+
+        next_open = {}
+        for start, last in runs:
+            rect = open_rects.get((start, last))
+            if rect is None:
+                rect = [int(start), y, int(last - start + 1), 0]
+                rects.append(rect)
+            rect[3] += 1
+            next_open[(start, last)] = rect
+        open_rects = next_open
+    return rects
+
+def encodeChunks(words):
+    # literal chunks with runs of min_run or more split out
+    data, lit, i, n = bytearray(), [], 0, len(words)
+
+    def flush():
+        if lit:
+            data.append(len(lit) - 1)
+            for w in lit:
+                data.extend((w >> 8, w & 0xff))
+            del lit[:]
+
+    while i < n:
+        j = i + 1
+        while j < n and j - i < CHUNK_MAX and words[j] == words[i]:
+            j += 1
+        if j - i >= min_run:
+            flush()
+            data += bytes((RUN | (j - i - 1), words[i] >> 8, words[i] & 0xff))
+            i = j
+            continue
+        lit.append(int(words[i]))
+        i += 1
+        if len(lit) == CHUNK_MAX:
+            flush()
+    flush()
+    return data
+
+def encodeDelta(prev, cur):
+    data = bytearray()
+    for col, row, width, height in changedRects(prev, cur):
+        data += bytes((SYNC, ord("R"), col, row, width, height))
+        data += encodeChunks(cur[row:row+height, col:col+width].ravel())
+    return data
+
+class Sender:
+    def __init__(self, fd):
+        self.fd = fd
+        self.unacked = 0
+        self.prev = None
+        self.cols = self.rows = 0
+
+    def readReply(self, timeout):
+        ready, _, _ = select.select([self.fd], [], [], timeout)
+        if not ready:
+            return None
+        reply = os.read(self.fd, 1)
+        if reply == b"K":
+            self.unacked = max(self.unacked - CREDIT, 0)
+        return reply
+
+    def readBytes(self, n, timeout):
+        data = b""
+        while len(data) < n:
+            ready, _, _ = select.select([self.fd], [], [], timeout)
+            if not ready:
+                raise IOError("short reply from board")
+            data += os.read(self.fd, n - len(data))
+        return data
+
+    def write(self, data):
+        # never more than WINDOW bytes in the receive buffer of the board
+        while data:
+            while self.unacked >= WINDOW:
+                if self.readReply(2.0) is None:
+                    raise IOError("board stopped answering")
+            piece = data[:WINDOW - self.unacked]
+            os.write(self.fd, piece)
+            self.unacked += len(piece)
+            data = data[len(piece):]
+
+    def hello(self, timeout=5.0):
+        # retried, opening the port may reset the board
+        end = time.time() + timeout
+        while time.time() < end:
+            termios.tcflush(self.fd, termios.TCIOFLUSH)
+            os.write(self.fd, bytes((SYNC, ord("H"))))
+            retry = time.time() + 0.5
+            while time.time() < retry:
+                if self.readReply(0.1) != b"H":
+                    continue
+                self.cols, self.rows = self.readBytes(2, 1.0)
+                self.unacked = 0
+                self.prev = None
+                return self.cols, self.rows
+        raise IOError("no answer from board")
+
+    def sendFrame(self, words, full=False):
+        data = encodeDelta(None if full else self.prev, words)
+        data += bytes((SYNC, ord("F")))
+        self.write(data)
+        while True:
+            reply = self.readReply(5.0)
+            if reply is None:
+                raise IOError("frame not acknowledged")
+            if reply == b"F":
+                break
+        self.prev = words
+        return len(data)
+
+def runBoard(save):
+    # lib/uc1698u_stream.cpp itself, built for Linux against the shim in
+    # board/ with the panel emulated, on a pseudo-terminal
+    here = os.path.dirname(os.path.abspath(__file__))
+    lib = os.path.join(here, "..", "..", "lib")
+    binary = os.path.join(here, "out", "board")
+    sources = [os.path.join(here, "board", "board.cpp")]
+    sources += [os.path.join(lib, f) for f in ("uc1698u.cpp", "uc1698u_stream.cpp", "uc1698u_profile.cpp")]
+    if not os.path.isdir(os.path.dirname(binary)):
+        os.mkdir(os.path.dirname(binary))
+    subprocess.check_call(["g++", "-std=gnu++11", "-O2", "-I" + os.path.join(here, "board"),
+                           "-I" + lib, "-o", binary] + sources + ["-lutil"])
+    os.execv(binary, [binary, save])
+
+def loadFrames(path):
+    img = cv2.imread(path, cv2.IMREAD_GRAYSCALE)
+    if img is not None:
+        yield img
+        return
+    video = cv2.VideoCapture(path)
+    while True:
+        ok, img = video.read()
+        if not ok:
+            break
+        yield cv2.cvtColor(img, cv2.COLOR_BGR2GRAY)
+
+def usage():
+    print("Usage: stream.py [--full] [--fps <n>] [--baud <n>] <port> <image|video>...")
+    print("       stream.py --board [<pgm>]")
+    sys.exit(1)
+
+if __name__ == "__main__":
+    args = sys.argv[1:]
+    if args[:1] == ["--board"]:
+        runBoard(args[1] if len(args) > 1 else "board.pgm")
+
+    full, fps, baud = False, 0, 115200
+    while args and args[0].startswith("--"):
+        opt = args.pop(0)
+        if opt == "--full":
+            full = True
+        elif opt == "--fps" and args:
+            fps = float(args.pop(0))
+        elif opt == "--baud" and args:
+            baud = int(args.pop(0))
+        else:
+            usage()
+    if len(args) < 2:
+        usage()
+
+    sender = Sender(openPort(args[0], baud))
+    cols, rows = sender.hello()
+    print("Connected, {} x {} tripixels".format(cols, rows))
+    raw = cols * rows * 2
+    for path in args[1:]:
+        for img in loadFrames(path):
+            start = time.time()
+            size = sender.sendFrame(encodeFrame(img, cols, rows, min(lcd_width, cols * 3)), full)
+            took = time.time() - start
+            print("{} bytes ({:.1f}% of raw) in {:.0f} ms".format(size, 100.0 * size / raw, took * 1000))
+            if fps and took < 1.0 / fps:
+                time.sleep(1.0 / fps - took)
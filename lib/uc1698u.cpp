@@ -1,4 +1,5 @@
 #include "uc1698u.h"
+#include "uc1698u_profile.h"
 
 #define BITSLICE(data, len, skip) (((data) >> (skip)) & ((1 << (len)) - 1))
 #define MAX(a,b) ((a) > (b) ? (a) : (b))
@@ -62,16 +63,16 @@ struct uc1698u_state uc1698u_default_state = {
 void
 uc1698u_64k_decode(uint8_t b1, uint8_t b2, uint8_t *r, uint8_t *g, uint8_t *b)
 {
-	*r = BITSLICE(b1, 5, 3);
-	*g = (BITSLICE(b1, 3, 0) << 3) | BITSLICE(b2, 3, 5);
-	*b = BITSLICE(b2, 5, 0);
+	*r = uc1698u_64k_decode_r(b1, b2);
+	*g = uc1698u_64k_decode_g(b1, b2);
+	*b = uc1698u_64k_decode_b(b1, b2);
 }
 
 void
 uc1698u_64k_encode(uint8_t *b1, uint8_t *b2, uint8_t r, uint8_t g, uint8_t b)
 {
-	*b1 = (BITSLICE(r, 5, 0) << 3) | BITSLICE(g, 3, 2);
-	*b2 = (BITSLICE(g, 2, 0) << 6) | BITSLICE(b, 5, 0);
+	*b1 = uc1698u_64k_encode_b1(r, g, b);
+	*b2 = uc1698u_64k_encode_b2(r, g, b);
 }
 
 /* init & test */
@@ -98,70 +99,99 @@ uc1698u_init_pins(struct uc1698u_config *config)
 	}
 }
 
-void
-uc1698u_init_erc160160(struct uc1698u_config *config)
-{
-	delay(500);
+const uint8_t uc1698u_erc160160_init[] PROGMEM = {
+	UC1698U_INIT_UPTIME, UC1698U_INIT_TPOR,
 
-	uc1698u_system_reset(config);
-	delay(500);
+	UC1698U_INIT_CMDS | 1,
+	UC1698U_OP_SYSTEM_RESET,
+	UC1698U_INIT_DELAY, UC1698U_INIT_TRD,
 
+	UC1698U_INIT_CMDS | 31,
 	/* power control */
-	uc1698u_set_lcd_bias_ratio(config, UC1698U_LCD_BIAS_RATIO_10);
-	uc1698u_set_power_control(config, UC1698U_POWER_CONTROL_INTERNAL |
-			UC1698U_POWER_CONTROL_MID_CAP);
-	uc1698u_set_temp_compensation(config, UC1698U_TEMP_COMPENSATION_NEG_Op00_PERCENT);
-	uc1698u_set_vbias_pot(config, 0xbf);
-
+	UC1698U_OP_LCD_BIAS_RATIO(UC1698U_LCD_BIAS_RATIO_10),
+	UC1698U_OP_POWER_CONTROL(UC1698U_POWER_CONTROL_INTERNAL | UC1698U_POWER_CONTROL_MID_CAP),
+	UC1698U_OP_TEMP_COMPENSATION(UC1698U_TEMP_COMPENSATION_NEG_Op00_PERCENT),
+	UC1698U_OP_VBIAS_POT(0xbf),
 	/* display control */
-	uc1698u_set_all_pixel(config, UC1698U_ALL_PIXEL_OFF);
-	uc1698u_set_inverse_display(config, UC1698U_INVERSE_DISABLE);
-
+	UC1698U_OP_ALL_PIXEL(UC1698U_ALL_PIXEL_OFF),
+	UC1698U_OP_INVERSE_DISPLAY(UC1698U_INVERSE_DISABLE),
 	/* lcd control */
-	uc1698u_set_lcd_mapping_control(config, UC1698U_LCD_PARTIAL_DISPLAY_DISABLE |
-			UC1698U_LCD_MIRROR_X_DISABLE | UC1698U_LCD_MIRROR_Y_DISABLE);
-	uc1698u_set_line_rate(config, UC1698U_32_SHADE_MODE_LINE_RATE_37p0_KILO_LINE_PER_SEC);
-	uc1698u_set_color_pattern(config, UC1698U_RGB_FILTER_ORDER_RGB_RGB);
-	uc1698u_set_color_mode(config, UC1698U_NORMAL_COLOR_MODE_64K);
-
+	UC1698U_OP_LCD_MAPPING_CONTROL(UC1698U_LCD_PARTIAL_DISPLAY_DISABLE
+			| UC1698U_LCD_MIRROR_X_DISABLE | UC1698U_LCD_MIRROR_Y_DISABLE),
+	UC1698U_OP_LINE_RATE(UC1698U_32_SHADE_MODE_LINE_RATE_37p0_KILO_LINE_PER_SEC),
+	UC1698U_OP_COLOR_PATTERN(UC1698U_RGB_FILTER_ORDER_RGB_RGB),
+	UC1698U_OP_COLOR_MODE(UC1698U_NORMAL_COLOR_MODE_64K),
 	/* nline inversion */
-	uc1698u_set_nline_inversion(config, UC1698U_NLINE_INV_37_LINES |
-			UC1698U_NLINE_INV_XOR_OFF | UC1698U_NLINE_INV_DISABLE);
-
+	UC1698U_OP_NLINE_INVERSION(UC1698U_NLINE_INV_37_LINES
+			| UC1698U_NLINE_INV_XOR_OFF | UC1698U_NLINE_INV_DISABLE),
 	/* com scan func */
-	uc1698u_set_com_scan_function(config, UC1698U_INTERLACE_SCAN_LRM_SEQ_AEBCD_AEBCD |
-			UC1698U_FRC_DISABLE | UC1698U_PWM_ON_SEG_OUTPUT);
-
-	/* winow */
-	uc1698u_set_window_prog_start_col_addr(config, 37);
-	uc1698u_set_window_prog_start_row_addr(config, 0);
-	uc1698u_set_window_prog_end_col_addr(config, 90);
-	uc1698u_set_window_prog_end_row_addr(config, 159);
-	uc1698u_set_window_prog_mode(config, UC1698U_WINDOW_PROG_INSIDE_MODE);
-
+	UC1698U_OP_COM_SCAN_FUNCTION(UC1698U_INTERLACE_SCAN_LRM_SEQ_AEBCD_AEBCD
+			| UC1698U_FRC_DISABLE | UC1698U_PWM_ON_SEG_OUTPUT),
+	/* window */
+	UC1698U_OP_WINDOW_START_COL(37),
+	UC1698U_OP_WINDOW_START_ROW(0),
+	UC1698U_OP_WINDOW_END_COL(90),
+	UC1698U_OP_WINDOW_END_ROW(159),
+	UC1698U_OP_WINDOW_PROG_MODE(UC1698U_WINDOW_PROG_INSIDE_MODE),
 	/* ram addr wraparound */
-	uc1698u_set_ram_address_control(config, UC1698U_AUTO_COL_ROW_WRAPAROUND_ENABLE |
-			UC1698U_AUTO_INCREMENT_COL_FIRST | UC1698U_ROW_ADDRESS_AUTO_INCREMENT_POS);
-
+	UC1698U_OP_RAM_ADDRESS_CONTROL(UC1698U_AUTO_COL_ROW_WRAPAROUND_ENABLE
+			| UC1698U_AUTO_INCREMENT_COL_FIRST | UC1698U_ROW_ADDRESS_AUTO_INCREMENT_POS),
 	/* partial display */
-	uc1698u_set_partial_display_control(config, UC1698U_PARTIAL_DISPLAY_CONTROL_DISABLE);
-	uc1698u_set_com_end(config, 160 - 1);
-	uc1698u_set_partial_display_start(config, 0);
-	uc1698u_set_partial_display_end(config, 160 - 1);
+	UC1698U_OP_PARTIAL_DISPLAY_CTRL(UC1698U_PARTIAL_DISPLAY_CONTROL_DISABLE),
+	UC1698U_OP_COM_END(160 - 1),
+	UC1698U_OP_PARTIAL_DISPLAY_START(0),
+	UC1698U_OP_PARTIAL_DISPLAY_END(160 - 1),
 
 	/* clear ram */
-	uc1698u_fill_screen_64K(config, 0b00000);
+	UC1698U_INIT_CLEAR, 0b00000,
 
 	/* use default scroll settings (no scroll or partial display) */
 
-	uc1698u_set_display_enable(config, UC1698U_DISPLAY_SLEEP | UC1698U_DISPLAY_MODE_32_SHADE |
-			UC1698U_DISPLAY_MODE_GREEN_ENHANCE_OFF);
+	UC1698U_INIT_CMDS | 1,
+	UC1698U_OP_DISPLAY_ENABLE(UC1698U_DISPLAY_SLEEP | UC1698U_DISPLAY_MODE_32_SHADE
+			| UC1698U_DISPLAY_MODE_GREEN_ENHANCE_OFF),
+
+	UC1698U_INIT_END
+};
+
+void
+uc1698u_init_table(struct uc1698u_config *config, const uint8_t *table)
+{
+	uint8_t op, len, i, cmds[63];
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_INIT);
+
+	while ((op = pgm_read_byte_near(table++)) != UC1698U_INIT_END) {
+		if ((op & 0xc0) == UC1698U_INIT_CMDS) {
+			len = BITSLICE(op, 6, 0);
+			uc1698u_write_begin(config, UC1698U_CMD);
+			for (i = 0; i < len; i++) {
+				cmds[i] = pgm_read_byte_near(table++);
+				uc1698u_write_byte(config, cmds[i]);
+			}
+			uc1698u_write_end(config);
+			uc1698u_track_cmds(config, cmds, len);
+		} else if (op == UC1698U_INIT_DELAY) {
+			delay(pgm_read_byte_near(table++));
+		} else if (op == UC1698U_INIT_UPTIME) {
+			len = pgm_read_byte_near(table++);
+			while (millis() < len) {}
+		} else if (op == UC1698U_INIT_CLEAR) {
+			uc1698u_fill_screen_64K(config, pgm_read_byte_near(table++));
+		}
+	}
+}
+
+void
+uc1698u_init_erc160160(struct uc1698u_config *config)
+{
+	uc1698u_init_table(config, uc1698u_erc160160_init);
 }
 
 void
 uc1698u_test_visual(struct uc1698u_config *config)
 {
 	int x, y;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_TEST_VISUAL);
 
 	uc1698u_set_pixpos(config, 0, 0);
 	for (y = 0; y < 160; y++) {
@@ -184,28 +214,218 @@ uc1698u_wake_display(struct uc1698u_config *config)
 void
 uc1698u_write(struct uc1698u_config *config, int type, int argcount, ...)
 {
-	int k, i;
-	uint8_t arg;
+	int k;
 	va_list ap;
 
+	uc1698u_write_begin(config, type);
+
+	va_start(ap, argcount);
+	for (k = 0; k < argcount; k++)
+		uc1698u_write_byte(config, va_arg(ap, int));
+	va_end(ap);
+
+	uc1698u_write_end(config);
+}
+
+void
+uc1698u_write_begin(struct uc1698u_config *config, int type)
+{
 	setPin(config->pin.CS, LOW);
 	setPin(config->pin.CD, BITSLICE(type, 1, 0));
+}
 
-	va_start(ap, argcount);
-	for (k = 0; k < argcount; k++) {
-		arg = va_arg(ap, int);
+void
+uc1698u_write_byte(struct uc1698u_config *config, uint8_t val)
+{
+	int i;
 
-		for (i = 0; i < 8; i++)
-			setPin(config->pin.DX[i], BITSLICE(arg, 1, i));
+	for (i = 0; i < 8; i++)
+		setPin(config->pin.DX[i], BITSLICE(val, 1, i));
 
-		setPin(config->pin.WR0, LOW);
-		setPin(config->pin.WR0, HIGH);
-	}
-	va_end(ap);
+	setPin(config->pin.WR0, LOW);
+	setPin(config->pin.WR0, HIGH);
+}
 
+void
+uc1698u_write_end(struct uc1698u_config *config)
+{
 	setPin(config->pin.CS, HIGH);
 }
 
+void
+uc1698u_write_repeat(struct uc1698u_config *config, int type,
+		uint8_t b1, uint8_t b2, uint16_t count)
+{
+	uint16_t k;
+
+	if (!count)
+		return;
+
+	uc1698u_write_begin(config, type);
+	if (b1 == b2) {
+		/* bus already holds the value, only strobe */
+		uc1698u_write_byte(config, b1);
+		uc1698u_write_byte(config, b2);
+		for (k = 1; k < count; k++) {
+			setPin(config->pin.WR0, LOW);
+			setPin(config->pin.WR0, HIGH);
+			setPin(config->pin.WR0, LOW);
+			setPin(config->pin.WR0, HIGH);
+		}
+	} else {
+		for (k = 0; k < count; k++) {
+			uc1698u_write_byte(config, b1);
+			uc1698u_write_byte(config, b2);
+		}
+	}
+	uc1698u_write_end(config);
+}
+
+void
+uc1698u_write_buf(struct uc1698u_config *config, int type,
+		const uint8_t *data, uint16_t len)
+{
+	uint16_t k;
+
+	uc1698u_write_begin(config, type);
+	for (k = 0; k < len; k++)
+		uc1698u_write_byte(config, data[k]);
+	uc1698u_write_end(config);
+}
+
+void
+uc1698u_write_buf_P(struct uc1698u_config *config, int type,
+		const uint8_t *data, uint16_t len)
+{
+	uint16_t k;
+
+	uc1698u_write_begin(config, type);
+	for (k = 0; k < len; k++)
+		uc1698u_write_byte(config, pgm_read_byte_near(data + k));
+	uc1698u_write_end(config);
+}
+
+void
+uc1698u_track_cmds(struct uc1698u_config *config, const uint8_t *cmds, uint8_t len)
+{
+	struct uc1698u_state *state = &config->state;
+	uint8_t i, c, arg;
+
+	for (i = 0; i < len; i++) {
+		c = cmds[i];
+		arg = (i + 1 < len) ? cmds[i + 1] : 0;
+
+		switch (c) {
+		case 0b10000001:
+			state->vbias_pot = arg;
+			i++;
+			continue;
+		case 0b10010000:
+			state->fixed_top = BITSLICE(arg, 4, 4);
+			state->fixed_bot = BITSLICE(arg, 4, 0);
+			i++;
+			continue;
+		case 0b10111000: /* mtp, not tracked */
+			i++;
+			continue;
+		case 0b10111001:
+			i += 2;
+			continue;
+		case 0b11001000:
+			state->niv_type = BITSLICE(arg, 3, 0);
+			state->niv_xor = BITSLICE(arg, 1, 3);
+			state->niv_enable = BITSLICE(arg, 1, 4);
+			i++;
+			continue;
+		case 0b11100010:
+			*state = uc1698u_default_state;
+			continue;
+		case 0b11110001:
+			state->com_end = arg;
+			i++;
+			continue;
+		case 0b11110010:
+			state->partial_disp_start = arg;
+			i++;
+			continue;
+		case 0b11110011:
+			state->partial_disp_end = arg;
+			i++;
+			continue;
+		case 0b11110100:
+			state->window_prog_start_col = BITSLICE(arg, 7, 0);
+			i++;
+			continue;
+		case 0b11110101:
+			state->window_prog_start_row = arg;
+			i++;
+			continue;
+		case 0b11110110:
+			state->window_prog_end_col = BITSLICE(arg, 7, 0);
+			i++;
+			continue;
+		case 0b11110111:
+			state->window_prog_end_row = arg;
+			i++;
+			continue;
+		}
+
+		if (BITSLICE(c, 4, 4) == 0b0000) {
+			state->col_addr = (state->col_addr & 0x70) | BITSLICE(c, 4, 0);
+		} else if (BITSLICE(c, 4, 4) == 0b0001) {
+			state->col_addr = (state->col_addr & 0x0f) | (BITSLICE(c, 3, 0) << 4);
+		} else if (BITSLICE(c, 6, 2) == 0b001001) {
+			state->temp_comp = BITSLICE(c, 2, 0);
+		} else if (BITSLICE(c, 6, 2) == 0b001010) {
+			state->power_internal = BITSLICE(c, 1, 1);
+			state->lcd_cap = BITSLICE(c, 1, 0);
+		} else if (BITSLICE(c, 3, 5) == 0b010) {
+			/* scroll line LSB / MSB */
+			if (BITSLICE(c, 1, 4))
+				state->scroll_rate = (state->scroll_rate & 0x0f) | (BITSLICE(c, 4, 0) << 4);
+			else
+				state->scroll_rate = (state->scroll_rate & 0xf0) | BITSLICE(c, 4, 0);
+		} else if (BITSLICE(c, 3, 5) == 0b011) {
+			if (BITSLICE(c, 1, 4))
+				state->row_addr = (state->row_addr & 0x0f) | (BITSLICE(c, 4, 0) << 4);
+			else
+				state->row_addr = (state->row_addr & 0xf0) | BITSLICE(c, 4, 0);
+		} else if (BITSLICE(c, 7, 1) == 0b1000010) {
+			state->partial_disp_ctrl = BITSLICE(c, 1, 0);
+		} else if (BITSLICE(c, 5, 3) == 0b10001) {
+			state->auto_wrap = BITSLICE(c, 1, 0);
+			state->auto_inc_order = BITSLICE(c, 1, 1);
+			state->auto_inc_dir = BITSLICE(c, 1, 2);
+		} else if (BITSLICE(c, 6, 2) == 0b101000) {
+			state->line_rate = BITSLICE(c, 2, 0);
+		} else if (BITSLICE(c, 7, 1) == 0b1010010) {
+			state->all_pixels = BITSLICE(c, 1, 0);
+		} else if (BITSLICE(c, 7, 1) == 0b1010011) {
+			state->pixel_inverse = BITSLICE(c, 1, 0);
+		} else if (BITSLICE(c, 5, 3) == 0b10101) {
+			state->display_sleep = BITSLICE(c, 1, 0);
+			state->display_mode = BITSLICE(c, 1, 1);
+			state->green_enhance = BITSLICE(c, 1, 2);
+		} else if (BITSLICE(c, 5, 3) == 0b11000) {
+			state->fixed_enable = BITSLICE(c, 1, 0);
+			state->mirror_x = BITSLICE(c, 1, 1);
+			state->mirror_y = BITSLICE(c, 1, 2);
+		} else if (BITSLICE(c, 7, 1) == 0b1101000) {
+			state->rgb_filter = BITSLICE(c, 1, 0);
+		} else if (BITSLICE(c, 6, 2) == 0b110101) {
+			state->color_mode = BITSLICE(c, 2, 0);
+		} else if (BITSLICE(c, 5, 3) == 0b11011) {
+			state->interlace_scan_func = BITSLICE(c, 1, 0);
+			state->frc_enable = BITSLICE(c, 1, 1);
+			state->shade_option = BITSLICE(c, 1, 2);
+		} else if (BITSLICE(c, 6, 2) == 0b111010) {
+			state->lcd_bias = BITSLICE(c, 2, 0);
+		} else if (BITSLICE(c, 7, 1) == 0b1111100) {
+			state->window_prog_mode = BITSLICE(c, 1, 0);
+		}
+	}
+}
+
 void
 uc1698u_read(struct uc1698u_config *config, int argcount, ...)
 {
@@ -247,6 +467,19 @@ uc1698u_set_pixpos(struct uc1698u_config *config, uint16_t x, uint16_t y)
 	uc1698u_set_row_address(config, config->state.window_prog_start_row + y);
 }
 
+void
+uc1698u_set_window(struct uc1698u_config *config, uint8_t start_col, uint8_t start_row,
+		uint8_t end_col, uint8_t end_row)
+{
+	config->state.window_prog_start_col = BITSLICE(start_col, 7, 0);
+	config->state.window_prog_start_row = start_row;
+	config->state.window_prog_end_col = BITSLICE(end_col, 7, 0);
+	config->state.window_prog_end_row = end_row;
+	uc1698u_write(config, UC1698U_CMD, 8,
+			UC1698U_OP_WINDOW_START_COL(start_col), UC1698U_OP_WINDOW_START_ROW(start_row),
+			UC1698U_OP_WINDOW_END_COL(end_col), UC1698U_OP_WINDOW_END_ROW(end_row));
+}
+
 void
 uc1698u_write_tripix_64K(struct uc1698u_config *config, uint8_t a, uint8_t b, uint8_t c)
 {
@@ -256,18 +489,26 @@ uc1698u_write_tripix_64K(struct uc1698u_config *config, uint8_t a, uint8_t b, ui
 	uc1698u_write(config, UC1698U_DATA, 2, b1, b2);
 }
 
+void
+uc1698u_read_tripix_64K(struct uc1698u_config *config, uint8_t *a, uint8_t *b, uint8_t *c)
+{
+	uint8_t dummy, b1 = 0, b2 = 0;
+
+	/* address was just set, first byte is the pipeline dummy read */
+	uc1698u_read(config, 3, &dummy, &b1, &b2);
+	uc1698u_64k_decode(b1, b2, a, b, c);
+}
+
 void
 uc1698u_write_pixel_64K(struct uc1698u_config *config, uint8_t x, uint8_t y, uint8_t val)
 {
-	uint8_t dummy, b1 = 0, b2 = 0, triplet[3] = { 0x00, 0x00, 0x00 };
+	uint8_t triplet[3] = { 0x00, 0x00, 0x00 };
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_WRITE_PIXEL);
 
 	uc1698u_set_col_address(config, config->state.window_prog_start_col + x / 3);
 	uc1698u_set_row_address(config, config->state.window_prog_start_row + y);
-	uc1698u_read(config, 3, &dummy, &b1, &b2);
-
-	uc1698u_64k_decode(b1, b2, &triplet[0], &triplet[1], &triplet[2]);
+	uc1698u_read_tripix_64K(config, &triplet[0], &triplet[1], &triplet[2]);
 	triplet[x % 3] = val;
-	uc1698u_64k_encode(&b1, &b2, triplet[0], triplet[1], triplet[2]);
 
 	uc1698u_set_row_address(config, config->state.window_prog_start_row + y);
 	uc1698u_set_col_address(config, config->state.window_prog_start_col + x / 3);
@@ -277,14 +518,16 @@ uc1698u_write_pixel_64K(struct uc1698u_config *config, uint8_t x, uint8_t y, uin
 void
 uc1698u_fill_screen_64K(struct uc1698u_config *config, uint8_t fill)
 {
-	int x, y;
+	uint8_t b1, b2;
+	uint16_t count;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_FILL_SCREEN);
+
+	count = (config->state.window_prog_end_col - config->state.window_prog_start_col + 1)
+		* (config->state.window_prog_end_row - config->state.window_prog_start_row + 1);
 
+	uc1698u_64k_encode(&b1, &b2, fill, fill, fill);
 	uc1698u_set_pixpos(config, 0, 0);
-	for (x = config->state.window_prog_start_col; x <= config->state.window_prog_end_col; x++) {
-		for (y = config->state.window_prog_start_row; y <= config->state.window_prog_end_row; y++) {
-			uc1698u_write_tripix_64K(config, fill, fill, fill);
-		}
-	}
+	uc1698u_write_repeat(config, UC1698U_DATA, b1, b2, count);
 }
 
 void
@@ -293,6 +536,7 @@ uc1698u_write_image_64K(struct uc1698u_config *config, const uint8_t *data,
 {
 	uint32_t si;
 	uint16_t x, y;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_WRITE_IMAGE);
 
 	for (y = 0; y < height; y++) {
 		uc1698u_set_pixpos(config, sx, sy + y);
@@ -306,6 +550,27 @@ uc1698u_write_image_64K(struct uc1698u_config *config, const uint8_t *data,
 	}
 }
 
+void
+uc1698u_write_packed_64K(struct uc1698u_config *config, const uint8_t *data,
+		uint16_t sx, uint16_t sy, uint16_t width, uint16_t height)
+{
+	uint8_t sc, sr, ec, er, cols;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_WRITE_PACKED);
+
+	sc = config->state.window_prog_start_col;
+	sr = config->state.window_prog_start_row;
+	ec = config->state.window_prog_end_col;
+	er = config->state.window_prog_end_row;
+	cols = (width + 2) / 3;
+
+	/* whole image in one burst through a window around it */
+	uc1698u_set_window(config, sc + sx / 3, sr + sy, sc + sx / 3 + cols - 1, sr + sy + height - 1);
+	uc1698u_set_col_address(config, sc + sx / 3);
+	uc1698u_set_row_address(config, sr + sy);
+	uc1698u_write_buf_P(config, UC1698U_DATA, data, cols * height * 2);
+	uc1698u_set_window(config, sc, sr, ec, er);
+}
+
 /* commands */
 
 void
@@ -402,10 +667,13 @@ uc1698u_set_inverse_display(struct uc1698u_config *config, int type)
 void
 uc1698u_set_display_enable(struct uc1698u_config *config, int type)
 {
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_DISPLAY_ENABLE);
+
 	uc1698u_write(config, UC1698U_CMD, 1, 0b10101000 | BITSLICE(type, 3, 0));
 	if (config->state.display_sleep == UC1698U_DISPLAY_SLEEP
 			&& BITSLICE(type, 1, 0) == UC1698U_DISPLAY_AWAKE) {
-		delay(100); /* wait on wake to avoid noise from inrush current pulse */
+		/* wait on wake to avoid noise from inrush current pulse */
+		delay(UC1698U_INIT_TDC2);
 	}
 	config->state.display_sleep = BITSLICE(type, 1, 0);
 	config->state.display_mode = BITSLICE(type, 1, 1);
@@ -69,9 +69,85 @@ struct uc1698u_config {
 void uc1698u_64k_decode(uint8_t b1, uint8_t b2, uint8_t *r, uint8_t *g, uint8_t *b);
 void uc1698u_64k_encode(uint8_t *b1, uint8_t *b2, uint8_t r, uint8_t g, uint8_t b);
 
+/* same as above, usable in constant expressions (see uc1698u_pack.h) */
+constexpr uint8_t uc1698u_64k_encode_b1(uint8_t r, uint8_t g, uint8_t /* b */)
+{
+	return ((r & 0x1f) << 3) | ((g >> 2) & 0x07);
+}
+
+constexpr uint8_t uc1698u_64k_encode_b2(uint8_t /* r */, uint8_t g, uint8_t b)
+{
+	return ((g & 0x03) << 6) | (b & 0x1f);
+}
+
+constexpr uint8_t uc1698u_64k_decode_r(uint8_t b1, uint8_t /* b2 */)
+{
+	return (b1 >> 3) & 0x1f;
+}
+
+constexpr uint8_t uc1698u_64k_decode_g(uint8_t b1, uint8_t b2)
+{
+	/* the shade sits in G5..G1, G0 is padding */
+	return ((b1 & 0x07) << 2) | ((b2 >> 6) & 0x03);
+}
+
+constexpr uint8_t uc1698u_64k_decode_b(uint8_t /* b1 */, uint8_t b2)
+{
+	return b2 & 0x1f;
+}
+
 /* init & test */
 
+/* Init tables are byte streams in PROGMEM made up of the steps below.
+ * Consecutive command bytes are sent in one burst, delays follow the
+ * datasheet (P.49-50, tRD on P.66) instead of fixed guesses. */
+enum {
+	UC1698U_INIT_END = 0x00,
+	UC1698U_INIT_CMDS = 0x40,   /* | n, followed by n (<= 63) command bytes */
+	UC1698U_INIT_DELAY = 0x80,  /* followed by delay in mS, at most 255 */
+	UC1698U_INIT_UPTIME = 0x81, /* followed by min. mS since power-up to wait for,
+	                             * one byte so at most 255 */
+	UC1698U_INIT_CLEAR = 0x82,  /* followed by shade to fill the window with */
+};
+
+#define UC1698U_INIT_TPOR 150  /* power-on-reset before first command */
+#define UC1698U_INIT_TRD  10   /* reset to first write */
+/* after display enable, the datasheet asks for 10 uS (P.49), this is a
+ * margin for the charge pump in-rush noise */
+#define UC1698U_INIT_TDC2 10
+
+/* command bytes, mirror the setters below */
+#define UC1698U_OP_COL_ADDRESS(v)          (0b00000000 | ((v) & 0x0f)), (0b00010000 | (((v) >> 4) & 0x07))
+#define UC1698U_OP_TEMP_COMPENSATION(t)    (0b00100100 | ((t) & 0b11))
+#define UC1698U_OP_POWER_CONTROL(t)        (0b00101000 | ((t) & 0b11))
+#define UC1698U_OP_ROW_ADDRESS(v)          (0b01100000 | ((v) & 0x0f)), (0b01110000 | (((v) >> 4) & 0x0f))
+#define UC1698U_OP_VBIAS_POT(v)            0b10000001, (v)
+#define UC1698U_OP_PARTIAL_DISPLAY_CTRL(t) (0b10000100 | ((t) & 0b1))
+#define UC1698U_OP_RAM_ADDRESS_CONTROL(t)  (0b10001000 | ((t) & 0b111))
+#define UC1698U_OP_LINE_RATE(t)            (0b10100000 | ((t) & 0b11))
+#define UC1698U_OP_ALL_PIXEL(t)            (0b10100100 | ((t) & 0b1))
+#define UC1698U_OP_INVERSE_DISPLAY(t)      (0b10100110 | ((t) & 0b1))
+#define UC1698U_OP_DISPLAY_ENABLE(t)       (0b10101000 | ((t) & 0b111))
+#define UC1698U_OP_LCD_MAPPING_CONTROL(t)  (0b11000000 | ((t) & 0b111))
+#define UC1698U_OP_NLINE_INVERSION(t)      0b11001000, ((t) & 0b11111)
+#define UC1698U_OP_COLOR_PATTERN(t)        (0b11010000 | ((t) & 0b1))
+#define UC1698U_OP_COLOR_MODE(t)           (0b11010100 | ((t) & 0b11))
+#define UC1698U_OP_COM_SCAN_FUNCTION(t)    (0b11011000 | ((t) & 0b111))
+#define UC1698U_OP_SYSTEM_RESET            0b11100010
+#define UC1698U_OP_LCD_BIAS_RATIO(t)       (0b11101000 | ((t) & 0b11))
+#define UC1698U_OP_COM_END(v)              0b11110001, (v)
+#define UC1698U_OP_PARTIAL_DISPLAY_START(v) 0b11110010, (v)
+#define UC1698U_OP_PARTIAL_DISPLAY_END(v)  0b11110011, (v)
+#define UC1698U_OP_WINDOW_START_COL(v)     0b11110100, ((v) & 0x7f)
+#define UC1698U_OP_WINDOW_START_ROW(v)     0b11110101, (v)
+#define UC1698U_OP_WINDOW_END_COL(v)       0b11110110, ((v) & 0x7f)
+#define UC1698U_OP_WINDOW_END_ROW(v)       0b11110111, (v)
+#define UC1698U_OP_WINDOW_PROG_MODE(t)     (0b11111000 | ((t) & 0b1))
+
+extern const uint8_t uc1698u_erc160160_init[];
+
 void uc1698u_init_pins(struct uc1698u_config *config);
+void uc1698u_init_table(struct uc1698u_config *config, const uint8_t *table);
 void uc1698u_init_erc160160(struct uc1698u_config *config);
 void uc1698u_test_visual(struct uc1698u_config *config);
 void uc1698u_wake_display(struct uc1698u_config *config);
@@ -86,16 +162,45 @@ enum {
 void uc1698u_write(struct uc1698u_config *config, int type, int argcount, ...);
 void uc1698u_read(struct uc1698u_config *config, int argcount, ...);
 
+/* burst writes, keep CS low between begin and end */
+void uc1698u_write_begin(struct uc1698u_config *config, int type);
+void uc1698u_write_byte(struct uc1698u_config *config, uint8_t val);
+void uc1698u_write_end(struct uc1698u_config *config);
+void uc1698u_write_repeat(struct uc1698u_config *config, int type,
+		uint8_t b1, uint8_t b2, uint16_t count);
+void uc1698u_write_buf(struct uc1698u_config *config, int type,
+		const uint8_t *data, uint16_t len);
+void uc1698u_write_buf_P(struct uc1698u_config *config, int type,
+		const uint8_t *data, uint16_t len); /* data in PROGMEM */
+
+/* update state from command bytes sent without the setters */
+void uc1698u_track_cmds(struct uc1698u_config *config, const uint8_t *cmds, uint8_t len);
+
 /* graphics */
 
+/* display data RAM width, in tripixel columns */
+#define UC1698U_SRAM_COLS 128
+
+struct uc1698u_point {
+	uint8_t x, y;
+};
+
 void uc1698u_set_pixpos(struct uc1698u_config *config, uint16_t x, uint16_t y);
 
+/* program window in absolute RAM addresses (columns count tripixels) */
+void uc1698u_set_window(struct uc1698u_config *config, uint8_t start_col, uint8_t start_row,
+		uint8_t end_col, uint8_t end_row);
+
 /* 64K colormode */
 void uc1698u_write_pixel_64K(struct uc1698u_config *config, uint8_t x, uint8_t y, uint8_t val);
 void uc1698u_fill_screen_64K(struct uc1698u_config *config, uint8_t fill);
 void uc1698u_write_tripix_64K(struct uc1698u_config *config, uint8_t a, uint8_t b, uint8_t c);
+void uc1698u_read_tripix_64K(struct uc1698u_config *config, uint8_t *a, uint8_t *b, uint8_t *c);
 void uc1698u_write_image_64K(struct uc1698u_config *config, const uint8_t *data,
 		uint16_t sx, uint16_t sy, uint16_t width, uint16_t height);
+/* data already in wire format (uc1698u_pack.h), sx must be a multiple of 3 */
+void uc1698u_write_packed_64K(struct uc1698u_config *config, const uint8_t *data,
+		uint16_t sx, uint16_t sy, uint16_t width, uint16_t height);
 
 /* commands */
 
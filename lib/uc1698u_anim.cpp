@@ -0,0 +1,88 @@
+#include "uc1698u_anim.h"
+#include "uc1698u_profile.h"
+
+static uint16_t
+anim_read_u16(const uint8_t *p)
+{
+	return pgm_read_byte_near(p) | (pgm_read_byte_near(p + 1) << 8);
+}
+
+void
+uc1698u_anim_init(struct uc1698u_anim *anim, const uint8_t *data, uint16_t interval)
+{
+	anim->data = data;
+	anim->frames = anim_read_u16(data);
+	anim->loop_frame = anim_read_u16(data + 2);
+	anim->loop_pos = NULL;
+	anim->interval = interval;
+	uc1698u_anim_rewind(anim);
+}
+
+void
+uc1698u_anim_rewind(struct uc1698u_anim *anim)
+{
+	anim->pos = anim->data + 4;
+	anim->frame = 0;
+	anim->next = millis();
+}
+
+uint8_t
+uc1698u_anim_draw_frame(struct uc1698u_config *config, struct uc1698u_anim *anim)
+{
+	uint8_t sc, sr, ec, er, col, row, width, height;
+	uint16_t rects;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_ANIM_FRAME);
+
+	if (anim->frame >= anim->frames)
+		return 0;
+
+	if (anim->frame == anim->loop_frame)
+		anim->loop_pos = anim->pos;
+
+	sc = config->state.window_prog_start_col;
+	sr = config->state.window_prog_start_row;
+	ec = config->state.window_prog_end_col;
+	er = config->state.window_prog_end_row;
+
+	rects = anim_read_u16(anim->pos);
+	anim->pos += 2;
+	while (rects--) {
+		col = pgm_read_byte_near(anim->pos + 0);
+		row = pgm_read_byte_near(anim->pos + 1);
+		width = pgm_read_byte_near(anim->pos + 2);
+		height = pgm_read_byte_near(anim->pos + 3);
+		anim->pos += 4;
+
+		uc1698u_set_window(config, sc + col, sr + row,
+				sc + col + width - 1, sr + row + height - 1);
+		uc1698u_set_col_address(config, sc + col);
+		uc1698u_set_row_address(config, sr + row);
+		uc1698u_write_buf_P(config, UC1698U_DATA, anim->pos, width * height * 2);
+		anim->pos += width * height * 2;
+	}
+	uc1698u_set_window(config, sc, sr, ec, er);
+
+	anim->frame++;
+	if (anim->frame == anim->frames && anim->loop_pos) {
+		anim->pos = anim->loop_pos;
+		anim->frame = anim->loop_frame;
+	}
+
+	return 1;
+}
+
+uint8_t
+uc1698u_anim_update(struct uc1698u_config *config, struct uc1698u_anim *anim)
+{
+	unsigned long now = millis();
+
+	if ((long) (now - anim->next) < 0)
+		return 0;
+
+	/* keep a steady rate, but do not try to catch up after a stall */
+	anim->next += anim->interval;
+	if ((long) (now - anim->next) >= 0)
+		anim->next = now + anim->interval;
+
+	return uc1698u_anim_draw_frame(config, anim);
+}
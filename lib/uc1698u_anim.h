@@ -0,0 +1,39 @@
+#ifndef UC1698U_ANIM_H
+#define UC1698U_ANIM_H
+
+/* Delta animation playback for 64K colormode
+ *
+ * Streams are generated by extra/convert/convert.py --anim and live in
+ * PROGMEM. Each frame only carries the rects of tripixels that changed
+ * since the previous one, already in wire format:
+ *
+ *   u16 frames, u16 loop frame (UC1698U_ANIM_NO_LOOP if none)
+ *   per frame: u16 rects
+ *     per rect: u8 col, u8 row, u8 width, u8 height (in tripixels / rows)
+ *               width * height * 2 encoded bytes, row by row
+ *
+ * u16 values are little endian, col / row are relative to the window set
+ * up on init. Every rect is sent as one windowed burst.
+*/
+
+#include "uc1698u.h"
+
+#define UC1698U_ANIM_NO_LOOP 0xffff
+
+struct uc1698u_anim {
+	const uint8_t *data, *pos, *loop_pos;
+	uint16_t frame, frames, loop_frame;
+	uint16_t interval; /* mS between frames */
+	unsigned long next;
+};
+
+void uc1698u_anim_init(struct uc1698u_anim *anim, const uint8_t *data, uint16_t interval);
+void uc1698u_anim_rewind(struct uc1698u_anim *anim);
+
+/* draw the next frame, returns 0 once a non-looping stream is done */
+uint8_t uc1698u_anim_draw_frame(struct uc1698u_config *config, struct uc1698u_anim *anim);
+
+/* draw the next frame if it is due, returns 1 if one was drawn */
+uint8_t uc1698u_anim_update(struct uc1698u_config *config, struct uc1698u_anim *anim);
+
+#endif // UC1698U_ANIM_H
@@ -0,0 +1,635 @@
+#include "uc1698u_gfx.h"
+#include "uc1698u_profile.h"
+
+#define MAX(a,b) ((a) > (b) ? (a) : (b))
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+#define BIT(v,n) (((v) >> (n)) & 1)
+#define SWAP(a,b) do { int16_t _t = (a); (a) = (b); (b) = _t; } while (0)
+
+const uint8_t uc1698u_font[] PROGMEM = {
+	0x00, 0x00, 0x00, 0x00, 0x00, /*   */
+	0x00, 0x00, 0x5f, 0x00, 0x00, /* ! */
+	0x00, 0x07, 0x00, 0x07, 0x00, /* " */
+	0x14, 0x7f, 0x14, 0x7f, 0x14, /* # */
+	0x24, 0x2a, 0x7f, 0x2a, 0x12, /* $ */
+	0x23, 0x13, 0x08, 0x64, 0x62, /* % */
+	0x36, 0x49, 0x55, 0x22, 0x50, /* & */
+	0x00, 0x05, 0x03, 0x00, 0x00, /* ' */
+	0x00, 0x1c, 0x22, 0x41, 0x00, /* ( */
+	0x00, 0x41, 0x22, 0x1c, 0x00, /* ) */
+	0x08, 0x2a, 0x1c, 0x2a, 0x08, /* * */
+	0x08, 0x08, 0x3e, 0x08, 0x08, /* + */
+	0x00, 0x50, 0x30, 0x00, 0x00, /* , */
+	0x08, 0x08, 0x08, 0x08, 0x08, /* - */
+	0x00, 0x60, 0x60, 0x00, 0x00, /* . */
+	0x20, 0x10, 0x08, 0x04, 0x02, /* / */
+	0x3e, 0x51, 0x49, 0x45, 0x3e, /* 0 */
+	0x00, 0x42, 0x7f, 0x40, 0x00, /* 1 */
+	0x42, 0x61, 0x51, 0x49, 0x46, /* 2 */
+	0x21, 0x41, 0x45, 0x4b, 0x31, /* 3 */
+	0x18, 0x14, 0x12, 0x7f, 0x10, /* 4 */
+	0x27, 0x45, 0x45, 0x45, 0x39, /* 5 */
+	0x3c, 0x4a, 0x49, 0x49, 0x30, /* 6 */
+	0x01, 0x71, 0x09, 0x05, 0x03, /* 7 */
+	0x36, 0x49, 0x49, 0x49, 0x36, /* 8 */
+	0x06, 0x49, 0x49, 0x29, 0x1e, /* 9 */
+	0x00, 0x36, 0x36, 0x00, 0x00, /* : */
+	0x00, 0x56, 0x36, 0x00, 0x00, /* ; */
+	0x08, 0x14, 0x22, 0x41, 0x00, /* < */
+	0x14, 0x14, 0x14, 0x14, 0x14, /* = */
+	0x00, 0x41, 0x22, 0x14, 0x08, /* > */
+	0x02, 0x01, 0x51, 0x09, 0x06, /* ? */
+	0x32, 0x49, 0x79, 0x41, 0x3e, /* @ */
+	0x7e, 0x11, 0x11, 0x11, 0x7e, /* A */
+	0x7f, 0x49, 0x49, 0x49, 0x36, /* B */
+	0x3e, 0x41, 0x41, 0x41, 0x22, /* C */
+	0x7f, 0x41, 0x41, 0x22, 0x1c, /* D */
+	0x7f, 0x49, 0x49, 0x49, 0x41, /* E */
+	0x7f, 0x09, 0x09, 0x09, 0x01, /* F */
+	0x3e, 0x41, 0x49, 0x49, 0x7a, /* G */
+	0x7f, 0x08, 0x08, 0x08, 0x7f, /* H */
+	0x00, 0x41, 0x7f, 0x41, 0x00, /* I */
+	0x20, 0x40, 0x41, 0x3f, 0x01, /* J */
+	0x7f, 0x08, 0x14, 0x22, 0x41, /* K */
+	0x7f, 0x40, 0x40, 0x40, 0x40, /* L */
+	0x7f, 0x02, 0x0c, 0x02, 0x7f, /* M */
+	0x7f, 0x04, 0x08, 0x10, 0x7f, /* N */
+	0x3e, 0x41, 0x41, 0x41, 0x3e, /* O */
+	0x7f, 0x09, 0x09, 0x09, 0x06, /* P */
+	0x3e, 0x41, 0x51, 0x21, 0x5e, /* Q */
+	0x7f, 0x09, 0x19, 0x29, 0x46, /* R */
+	0x46, 0x49, 0x49, 0x49, 0x31, /* S */
+	0x01, 0x01, 0x7f, 0x01, 0x01, /* T */
+	0x3f, 0x40, 0x40, 0x40, 0x3f, /* U */
+	0x1f, 0x20, 0x40, 0x20, 0x1f, /* V */
+	0x3f, 0x40, 0x38, 0x40, 0x3f, /* W */
+	0x63, 0x14, 0x08, 0x14, 0x63, /* X */
+	0x07, 0x08, 0x70, 0x08, 0x07, /* Y */
+	0x61, 0x51, 0x49, 0x45, 0x43, /* Z */
+	0x00, 0x7f, 0x41, 0x41, 0x00, /* [ */
+	0x02, 0x04, 0x08, 0x10, 0x20, /* \ */
+	0x00, 0x41, 0x41, 0x7f, 0x00, /* ] */
+	0x04, 0x02, 0x01, 0x02, 0x04, /* ^ */
+	0x40, 0x40, 0x40, 0x40, 0x40, /* _ */
+	0x00, 0x01, 0x02, 0x04, 0x00, /* ` */
+	0x20, 0x54, 0x54, 0x54, 0x78, /* a */
+	0x7f, 0x48, 0x44, 0x44, 0x38, /* b */
+	0x38, 0x44, 0x44, 0x44, 0x20, /* c */
+	0x38, 0x44, 0x44, 0x48, 0x7f, /* d */
+	0x38, 0x54, 0x54, 0x54, 0x18, /* e */
+	0x08, 0x7e, 0x09, 0x01, 0x02, /* f */
+	0x0c, 0x52, 0x52, 0x52, 0x3e, /* g */
+	0x7f, 0x08, 0x04, 0x04, 0x78, /* h */
+	0x00, 0x44, 0x7d, 0x40, 0x00, /* i */
+	0x20, 0x40, 0x44, 0x3d, 0x00, /* j */
+	0x7f, 0x10, 0x28, 0x44, 0x00, /* k */
+	0x00, 0x41, 0x7f, 0x40, 0x00, /* l */
+	0x7c, 0x04, 0x18, 0x04, 0x78, /* m */
+	0x7c, 0x08, 0x04, 0x04, 0x78, /* n */
+	0x38, 0x44, 0x44, 0x44, 0x38, /* o */
+	0x7c, 0x14, 0x14, 0x14, 0x08, /* p */
+	0x08, 0x14, 0x14, 0x18, 0x7c, /* q */
+	0x7c, 0x08, 0x04, 0x04, 0x08, /* r */
+	0x48, 0x54, 0x54, 0x54, 0x20, /* s */
+	0x04, 0x3f, 0x44, 0x40, 0x20, /* t */
+	0x3c, 0x40, 0x40, 0x20, 0x7c, /* u */
+	0x1c, 0x20, 0x40, 0x20, 0x1c, /* v */
+	0x3c, 0x40, 0x30, 0x40, 0x3c, /* w */
+	0x44, 0x28, 0x10, 0x28, 0x44, /* x */
+	0x0c, 0x50, 0x50, 0x50, 0x3c, /* y */
+	0x44, 0x64, 0x54, 0x4c, 0x44, /* z */
+	0x00, 0x08, 0x36, 0x41, 0x00, /* { */
+	0x00, 0x00, 0x7f, 0x00, 0x00, /* | */
+	0x00, 0x41, 0x36, 0x08, 0x00, /* } */
+	0x08, 0x04, 0x08, 0x10, 0x08, /* ~ */
+};
+
+/* helper */
+
+static uint8_t
+gfx_clip(struct uc1698u_config *config, int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1)
+{
+	int16_t width, height;
+
+	width = (config->state.window_prog_end_col - config->state.window_prog_start_col + 1) * 3;
+	height = config->state.window_prog_end_row - config->state.window_prog_start_row + 1;
+
+	if (*x0 > *x1) SWAP(*x0, *x1);
+	if (*y0 > *y1) SWAP(*y0, *y1);
+	if (*x1 < 0 || *y1 < 0 || *x0 >= width || *y0 >= height)
+		return 0;
+
+	*x0 = MAX(*x0, 0);
+	*y0 = MAX(*y0, 0);
+	*x1 = MIN(*x1, width - 1);
+	*y1 = MIN(*y1, height - 1);
+
+	return 1;
+}
+
+static void
+gfx_fill(struct uc1698u_config *config, int16_t x0, int16_t y0,
+		int16_t x1, int16_t y1, uint8_t val)
+{
+	uint8_t sc, sr, ec, er, c0, c1, head, tail, b1, b2, i;
+	uint8_t first[3] = { 0, 0, 0 }, last[3] = { 0, 0, 0 };
+	int16_t y;
+
+	if (!gfx_clip(config, &x0, &y0, &x1, &y1))
+		return;
+
+	sc = config->state.window_prog_start_col;
+	sr = config->state.window_prog_start_row;
+	ec = config->state.window_prog_end_col;
+	er = config->state.window_prog_end_row;
+
+	c0 = x0 / 3;
+	c1 = x1 / 3;
+	head = (x0 % 3 != 0);
+	tail = (x1 % 3 != 2);
+	uc1698u_64k_encode(&b1, &b2, val, val, val);
+
+	if (!head && !tail) {
+		/* aligned, one burst through a window around the rect */
+		if (y0 != y1)
+			uc1698u_set_window(config, sc + c0, sr + y0, sc + c1, sr + y1);
+		uc1698u_set_col_address(config, sc + c0);
+		uc1698u_set_row_address(config, sr + y0);
+		uc1698u_write_repeat(config, UC1698U_DATA, b1, b2, (c1 - c0 + 1) * (y1 - y0 + 1));
+		if (y0 != y1)
+			uc1698u_set_window(config, sc, sr, ec, er);
+		return;
+	}
+
+	for (y = y0; y <= y1; y++) {
+		if (head || c0 == c1) {
+			uc1698u_set_col_address(config, sc + c0);
+			uc1698u_set_row_address(config, sr + y);
+			uc1698u_read_tripix_64K(config, &first[0], &first[1], &first[2]);
+		}
+
+		if (c0 == c1) {
+			/* span inside a single tripixel */
+			for (i = x0 % 3; i <= x1 % 3; i++)
+				first[i] = val;
+			uc1698u_set_col_address(config, sc + c0);
+			uc1698u_set_row_address(config, sr + y);
+			uc1698u_write_tripix_64K(config, first[0], first[1], first[2]);
+			continue;
+		}
+
+		if (tail) {
+			uc1698u_set_col_address(config, sc + c1);
+			uc1698u_set_row_address(config, sr + y);
+			uc1698u_read_tripix_64K(config, &last[0], &last[1], &last[2]);
+		}
+
+		/* row is contiguous in RAM, write merged ends and body in one pass */
+		uc1698u_set_col_address(config, sc + c0);
+		uc1698u_set_row_address(config, sr + y);
+		if (head) {
+			for (i = x0 % 3; i < 3; i++)
+				first[i] = val;
+			uc1698u_write_tripix_64K(config, first[0], first[1], first[2]);
+		}
+		uc1698u_write_repeat(config, UC1698U_DATA, b1, b2,
+				(c1 - c0 + 1) - head - tail);
+		if (tail) {
+			for (i = 0; i <= x1 % 3; i++)
+				last[i] = val;
+			uc1698u_write_tripix_64K(config, last[0], last[1], last[2]);
+		}
+	}
+}
+
+static void
+gfx_row(struct uc1698u_config *config, int16_t x, int16_t y,
+		const uint8_t *shades, int16_t width, uint8_t progmem)
+{
+	uint8_t sc, sr, c, i, b1, b2, t[3];
+	uint8_t first[3] = { 0, 0, 0 }, last[3] = { 0, 0, 0 };
+	int16_t x0, x1, y1, px;
+
+	x0 = x;
+	x1 = x + width - 1;
+	y1 = y;
+	if (width <= 0 || !gfx_clip(config, &x0, &y, &x1, &y1))
+		return;
+
+	sc = config->state.window_prog_start_col;
+	sr = config->state.window_prog_start_row;
+
+	if (x0 % 3 != 0 || (x1 % 3 != 2 && x0 / 3 == x1 / 3)) {
+		uc1698u_set_col_address(config, sc + x0 / 3);
+		uc1698u_set_row_address(config, sr + y);
+		uc1698u_read_tripix_64K(config, &first[0], &first[1], &first[2]);
+		memcpy(last, first, 3);
+	}
+	if (x1 % 3 != 2 && x0 / 3 != x1 / 3) {
+		uc1698u_set_col_address(config, sc + x1 / 3);
+		uc1698u_set_row_address(config, sr + y);
+		uc1698u_read_tripix_64K(config, &last[0], &last[1], &last[2]);
+	}
+
+	uc1698u_set_col_address(config, sc + x0 / 3);
+	uc1698u_set_row_address(config, sr + y);
+	uc1698u_write_begin(config, UC1698U_DATA);
+	for (c = x0 / 3; c <= x1 / 3; c++) {
+		for (i = 0; i < 3; i++) {
+			px = c * 3 + i;
+			if (px < x0)
+				t[i] = first[i];
+			else if (px > x1)
+				t[i] = last[i];
+			else if (progmem)
+				t[i] = pgm_read_byte_near(shades + px - x);
+			else
+				t[i] = shades[px - x];
+		}
+		uc1698u_64k_encode(&b1, &b2, t[0], t[1], t[2]);
+		uc1698u_write_byte(config, b1);
+		uc1698u_write_byte(config, b2);
+	}
+	uc1698u_write_end(config);
+}
+
+/* points of one row, each touched tripixel is read-modify-written at most
+ * once and runs of adjacent ones go out in one burst */
+static void
+gfx_pixels_row(struct uc1698u_config *config, const struct uc1698u_point *points,
+		uint8_t *order, uint8_t n, uint8_t y, uint8_t val)
+{
+	uint8_t buf[UC1698U_GFX_ROW_MAX / 3 * 2], t[3];
+	uint8_t sc, sr, i, j, k, c, c0, len, mask;
+
+	sc = config->state.window_prog_start_col;
+	sr = config->state.window_prog_start_row;
+
+	/* by x, rows hold few points */
+	for (i = 1; i < n; i++) {
+		k = order[i];
+		for (j = i; j > 0 && points[order[j - 1]].x > points[k].x; j--)
+			order[j] = order[j - 1];
+		order[j] = k;
+	}
+
+	for (i = 0; i < n; ) {
+		c0 = points[order[i]].x / 3;
+		for (len = 0; i < n && points[order[i]].x / 3 == c0 + len; len++) {
+			c = c0 + len;
+			for (mask = 0; i < n && points[order[i]].x / 3 == c; i++)
+				mask |= 1 << (points[order[i]].x % 3);
+
+			t[0] = t[1] = t[2] = val;
+			if (mask != 0x07) {
+				uc1698u_set_col_address(config, sc + c);
+				uc1698u_set_row_address(config, sr + y);
+				uc1698u_read_tripix_64K(config, &t[0], &t[1], &t[2]);
+				for (k = 0; k < 3; k++) {
+					if (BIT(mask, k))
+						t[k] = val;
+				}
+			}
+			uc1698u_64k_encode(&buf[len * 2], &buf[len * 2 + 1], t[0], t[1], t[2]);
+		}
+
+		uc1698u_set_col_address(config, sc + c0);
+		uc1698u_set_row_address(config, sr + y);
+		uc1698u_write_buf(config, UC1698U_DATA, buf, len * 2);
+	}
+}
+
+/* primitives */
+
+void
+uc1698u_draw_span_64K(struct uc1698u_config *config,
+		int16_t x0, int16_t x1, int16_t y, uint8_t val)
+{
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_SPAN);
+
+	gfx_fill(config, x0, y, x1, y, val);
+}
+
+void
+uc1698u_draw_line_64K(struct uc1698u_config *config,
+		int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t val)
+{
+	int16_t dx, dy, sx, sy, err, e2, nx, ny, run;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_LINE);
+
+	dx = abs(x1 - x0);
+	dy = -abs(y1 - y0);
+	sx = (x0 < x1) ? 1 : -1;
+	sy = (y0 < y1) ? 1 : -1;
+	err = dx + dy;
+
+	/* bresenham, pixels on the same row are collected into one span */
+	run = x0;
+	while (x0 != x1 || y0 != y1) {
+		e2 = 2 * err;
+		nx = x0;
+		ny = y0;
+		if (e2 >= dy) {
+			err += dy;
+			nx += sx;
+		}
+		if (e2 <= dx) {
+			err += dx;
+			ny += sy;
+		}
+		if (ny != y0) {
+			uc1698u_draw_span_64K(config, run, x0, y0, val);
+			run = nx;
+		}
+		x0 = nx;
+		y0 = ny;
+	}
+	uc1698u_draw_span_64K(config, run, x0, y0, val);
+}
+
+void
+uc1698u_draw_rect_64K(struct uc1698u_config *config,
+		int16_t x, int16_t y, int16_t width, int16_t height, uint8_t val)
+{
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_DRAW_RECT);
+
+	if (width <= 0 || height <= 0)
+		return;
+
+	gfx_fill(config, x, y, x + width - 1, y, val);
+	if (height > 1)
+		gfx_fill(config, x, y + height - 1, x + width - 1, y + height - 1, val);
+	if (height > 2) {
+		gfx_fill(config, x, y + 1, x, y + height - 2, val);
+		if (width > 1)
+			gfx_fill(config, x + width - 1, y + 1, x + width - 1, y + height - 2, val);
+	}
+}
+
+void
+uc1698u_fill_rect_64K(struct uc1698u_config *config,
+		int16_t x, int16_t y, int16_t width, int16_t height, uint8_t val)
+{
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_FILL_RECT);
+
+	if (width <= 0 || height <= 0)
+		return;
+
+	gfx_fill(config, x, y, x + width - 1, y + height - 1, val);
+}
+
+void
+uc1698u_fill_outside_64K(struct uc1698u_config *config,
+		int16_t x, int16_t y, int16_t width, int16_t height, uint8_t val, uint8_t method)
+{
+	uint8_t sc, sr, ec, er, mode, c0, c1, b1, b2;
+	int16_t x0, y0, x1, y1, cols, rows;
+	uint16_t burst, bands;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_OUTSIDE);
+
+	x0 = x;
+	y0 = y;
+	x1 = x + width - 1;
+	y1 = y + height - 1;
+	if (width <= 0 || height <= 0 || !gfx_clip(config, &x0, &y0, &x1, &y1)) {
+		uc1698u_fill_screen_64K(config, val);
+		return;
+	}
+
+	sc = config->state.window_prog_start_col;
+	sr = config->state.window_prog_start_row;
+	ec = config->state.window_prog_end_col;
+	er = config->state.window_prog_end_row;
+	mode = config->state.window_prog_mode;
+	cols = ec - sc + 1;
+	rows = er - sr + 1;
+	c0 = x0 / 3;
+	c1 = x1 / 3;
+
+	/* outside mode wraps over all of SRAM, so the burst also runs through the
+	 * columns beside the window, each band costs about 10 tripixels of commands */
+	burst = (rows - 1) * UC1698U_SRAM_COLS + cols;
+	bands = cols * rows - (c1 - c0 + 1) * (y1 - y0 + 1) + 30;
+
+	if (method == UC1698U_FILL_OUTSIDE_BURST
+			|| (method == UC1698U_FILL_OUTSIDE_AUTO && burst <= bands)) {
+		uc1698u_64k_encode(&b1, &b2, val, val, val);
+		uc1698u_set_window(config, sc + c0, sr + y0, sc + c1, sr + y1);
+		uc1698u_set_window_prog_mode(config, UC1698U_WINDOW_PROG_OUTSIDE_MODE);
+		/* the mode change leaves the address alone, set it afterwards */
+		uc1698u_set_col_address(config, sc);
+		uc1698u_set_row_address(config, sr);
+		uc1698u_write_repeat(config, UC1698U_DATA, b1, b2, burst);
+		uc1698u_set_window_prog_mode(config, mode);
+		uc1698u_set_window(config, sc, sr, ec, er);
+		return;
+	}
+
+	/* all aligned, one burst each */
+	if (y0 > 0)
+		gfx_fill(config, 0, 0, cols * 3 - 1, y0 - 1, val);
+	if (y1 < rows - 1)
+		gfx_fill(config, 0, y1 + 1, cols * 3 - 1, rows - 1, val);
+	if (c0 > 0)
+		gfx_fill(config, 0, y0, c0 * 3 - 1, y1, val);
+	if (c1 < cols - 1)
+		gfx_fill(config, (c1 + 1) * 3, y0, cols * 3 - 1, y1, val);
+}
+
+void
+uc1698u_draw_circle_64K(struct uc1698u_config *config,
+		int16_t cx, int16_t cy, int16_t r, uint8_t val)
+{
+	int16_t dy, xo, xn, lo;
+	int32_t rr;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_DRAW_CIRCLE);
+
+	if (r < 0)
+		return;
+
+	/* xo is the outer half-width of row dy, the outline of a row reaches
+	 * inward up to where the next row starts */
+	rr = (int32_t) r * r + r;
+	xo = r;
+	for (dy = 0; dy <= r; dy++) {
+		xn = xo;
+		while (xn >= 0 && (int32_t) xn * xn + (int32_t) (dy + 1) * (dy + 1) > rr)
+			xn--;
+		lo = MIN(xn + 1, xo);
+
+		if (lo == 0) {
+			uc1698u_draw_span_64K(config, cx - xo, cx + xo, cy + dy, val);
+			if (dy)
+				uc1698u_draw_span_64K(config, cx - xo, cx + xo, cy - dy, val);
+		} else {
+			uc1698u_draw_span_64K(config, cx - xo, cx - lo, cy + dy, val);
+			uc1698u_draw_span_64K(config, cx + lo, cx + xo, cy + dy, val);
+			if (dy) {
+				uc1698u_draw_span_64K(config, cx - xo, cx - lo, cy - dy, val);
+				uc1698u_draw_span_64K(config, cx + lo, cx + xo, cy - dy, val);
+			}
+		}
+		xo = xn;
+	}
+}
+
+void
+uc1698u_fill_circle_64K(struct uc1698u_config *config,
+		int16_t cx, int16_t cy, int16_t r, uint8_t val)
+{
+	int16_t dy, xo;
+	int32_t rr;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_FILL_CIRCLE);
+
+	if (r < 0)
+		return;
+
+	rr = (int32_t) r * r + r;
+	xo = r;
+	for (dy = 0; dy <= r; dy++) {
+		while ((int32_t) xo * xo + (int32_t) dy * dy > rr)
+			xo--;
+		uc1698u_draw_span_64K(config, cx - xo, cx + xo, cy + dy, val);
+		if (dy)
+			uc1698u_draw_span_64K(config, cx - xo, cx + xo, cy - dy, val);
+	}
+}
+
+void
+uc1698u_fill_polygon_64K(struct uc1698u_config *config,
+		const struct uc1698u_point *pts, uint8_t count, uint8_t val)
+{
+	int16_t nodes[UC1698U_GFX_POLY_NODES], y, ymin, ymax, t;
+	uint8_t i, j, k, n;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_POLYGON);
+
+	if (count < 3)
+		return;
+
+	ymin = ymax = pts[0].y;
+	for (i = 1; i < count; i++) {
+		ymin = MIN(ymin, pts[i].y);
+		ymax = MAX(ymax, pts[i].y);
+	}
+
+	/* even-odd scanline fill sampled at pixel centers */
+	for (y = ymin; y < ymax; y++) {
+		n = 0;
+		for (i = 0, j = count - 1; i < count; j = i++) {
+			if ((pts[i].y <= y) == (pts[j].y <= y))
+				continue;
+			if (n == UC1698U_GFX_POLY_NODES)
+				break;
+			nodes[n++] = pts[i].x + (int32_t) (2 * (y - pts[i].y) + 1)
+				* (pts[j].x - pts[i].x) / (2 * (pts[j].y - pts[i].y));
+		}
+
+		for (i = 1; i < n; i++) {
+			t = nodes[i];
+			for (k = i; k > 0 && nodes[k - 1] > t; k--)
+				nodes[k] = nodes[k - 1];
+			nodes[k] = t;
+		}
+
+		for (i = 0; i + 1 < n; i += 2)
+			uc1698u_draw_span_64K(config, nodes[i], nodes[i + 1], y, val);
+	}
+}
+
+void
+uc1698u_write_row_64K(struct uc1698u_config *config,
+		int16_t x, int16_t y, const uint8_t *shades, uint8_t width)
+{
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_WRITE_ROW);
+
+	gfx_row(config, x, y, shades, width, 0);
+}
+
+void
+uc1698u_write_row_64K_P(struct uc1698u_config *config,
+		int16_t x, int16_t y, const uint8_t *shades, uint8_t width)
+{
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_WRITE_ROW_P);
+
+	gfx_row(config, x, y, shades, width, 1);
+}
+
+void
+uc1698u_write_pixels_64K(struct uc1698u_config *config,
+		const struct uc1698u_point *points, uint16_t count, uint8_t val)
+{
+	uint8_t start[UC1698U_GFX_HEIGHT_MAX + 1], order[UC1698U_GFX_PIXELS_BATCH];
+	uint8_t cols, height, n, i, k, y;
+	const struct uc1698u_point *p;
+	uint16_t base;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_PIXELS);
+
+	cols = MIN(config->state.window_prog_end_col - config->state.window_prog_start_col + 1,
+			UC1698U_GFX_ROW_MAX / 3);
+	height = MIN(config->state.window_prog_end_row - config->state.window_prog_start_row + 1,
+			UC1698U_GFX_HEIGHT_MAX);
+
+	for (base = 0; base < count; base += n) {
+		n = MIN(count - base, UC1698U_GFX_PIXELS_BATCH);
+
+		/* counting sort by row, start[y] ends up as the end of row y */
+		memset(start, 0, height + 1);
+		for (i = 0; i < n; i++) {
+			p = &points[base + i];
+			if (p->x < cols * 3 && p->y < height)
+				start[p->y + 1]++;
+		}
+		for (y = 0; y < height; y++)
+			start[y + 1] += start[y];
+		for (i = 0; i < n; i++) {
+			p = &points[base + i];
+			if (p->x < cols * 3 && p->y < height)
+				order[start[p->y]++] = i;
+		}
+
+		for (y = 0, k = 0; y < height; k = start[y++]) {
+			if (start[y] != k)
+				gfx_pixels_row(config, points + base, order + k, start[y] - k, y, val);
+		}
+	}
+}
+
+void
+uc1698u_draw_image_64K(struct uc1698u_config *config,
+		int16_t x, int16_t y, const struct uc1698u_asset *asset)
+{
+	uint8_t r;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_DRAW_IMAGE);
+
+	for (r = 0; r < asset->height; r++) {
+		gfx_row(config, x, y + r, asset->data + (uint16_t) r * asset->width,
+				asset->width, 1);
+	}
+}
+
+void
+uc1698u_draw_text_64K(struct uc1698u_config *config,
+		int16_t x, int16_t y, const char *text, uint8_t fg, uint8_t bg)
+{
+	uint8_t row[UC1698U_GFX_ROW_MAX], len, r, i, k, ch;
+	const uint8_t *glyph;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_TEXT);
+
+	len = MIN(strlen(text), UC1698U_GFX_ROW_MAX / UC1698U_FONT_WIDTH);
+
+	/* one burst per pixel row of the whole string */
+	for (r = 0; r < UC1698U_FONT_HEIGHT; r++) {
+		for (i = 0; i < len; i++) {
+			ch = text[i];
+			if (ch < 0x20 || ch > 0x7e)
+				ch = '?';
+			glyph = uc1698u_font + (ch - 0x20) * 5;
+			for (k = 0; k < 5; k++) {
+				row[i * UC1698U_FONT_WIDTH + k] =
+					BIT(pgm_read_byte_near(glyph + k), r) ? fg : bg;
+			}
+			row[i * UC1698U_FONT_WIDTH + 5] = bg;
+		}
+		gfx_row(config, x, y + r, row, len * UC1698U_FONT_WIDTH, 0);
+	}
+}
@@ -0,0 +1,81 @@
+#ifndef UC1698U_GFX_H
+#define UC1698U_GFX_H
+
+/* Vector primitives for 64K colormode
+ *
+ * Shapes are rasterised into horizontal spans. Each span is written as one
+ * tripixel-aligned burst, only partial tripixels at the span ends are
+ * read-modify-written. Filled rects without partial ends take a single
+ * burst through the window program.
+ *
+ * Coordinates are pixels relative to the window set up on init and are
+ * clipped against it.
+*/
+
+#include "uc1698u.h"
+
+/* max edge crossings per scanline for uc1698u_fill_polygon_64K */
+#define UC1698U_GFX_POLY_NODES 16
+
+/* max pixels per row buffer, one full row of the ERC160160 window */
+#define UC1698U_GFX_ROW_MAX 162
+
+/* max window rows, all of display RAM */
+#define UC1698U_GFX_HEIGHT_MAX 160
+
+/* points sorted per pass of uc1698u_write_pixels_64K */
+#define UC1698U_GFX_PIXELS_BATCH 64
+
+/* 5x7 font in a 6x8 cell, ASCII 0x20 - 0x7e */
+#define UC1698U_FONT_WIDTH 6
+#define UC1698U_FONT_HEIGHT 8
+
+extern const uint8_t uc1698u_font[]; /* 5 column bytes per glyph, LSB on top */
+
+struct uc1698u_asset {
+	const uint8_t *data; /* PROGMEM, one shade per pixel like img.h */
+	uint8_t width, height;
+};
+
+void uc1698u_draw_span_64K(struct uc1698u_config *config,
+		int16_t x0, int16_t x1, int16_t y, uint8_t val);
+void uc1698u_draw_line_64K(struct uc1698u_config *config,
+		int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t val);
+void uc1698u_draw_rect_64K(struct uc1698u_config *config,
+		int16_t x, int16_t y, int16_t width, int16_t height, uint8_t val);
+void uc1698u_fill_rect_64K(struct uc1698u_config *config,
+		int16_t x, int16_t y, int16_t width, int16_t height, uint8_t val);
+/* fill the whole window except the rect, grown to whole tripixels */
+enum {
+	UC1698U_FILL_OUTSIDE_AUTO,  /* whichever moves fewer bytes */
+	UC1698U_FILL_OUTSIDE_BURST, /* one burst in window program outside mode, runs
+	                             * through all SRAM columns and the rect */
+	UC1698U_FILL_OUTSIDE_BANDS  /* one burst per band around the rect */
+};
+void uc1698u_fill_outside_64K(struct uc1698u_config *config,
+		int16_t x, int16_t y, int16_t width, int16_t height, uint8_t val, uint8_t method);
+void uc1698u_draw_circle_64K(struct uc1698u_config *config,
+		int16_t cx, int16_t cy, int16_t r, uint8_t val);
+void uc1698u_fill_circle_64K(struct uc1698u_config *config,
+		int16_t cx, int16_t cy, int16_t r, uint8_t val);
+void uc1698u_fill_polygon_64K(struct uc1698u_config *config,
+		const struct uc1698u_point *pts, uint8_t count, uint8_t val);
+
+/* rows of shades at any x, partial tripixels at the ends are merged */
+void uc1698u_write_row_64K(struct uc1698u_config *config,
+		int16_t x, int16_t y, const uint8_t *shades, uint8_t width);
+void uc1698u_write_row_64K_P(struct uc1698u_config *config,
+		int16_t x, int16_t y, const uint8_t *shades, uint8_t width); /* shades in PROGMEM */
+void uc1698u_draw_image_64K(struct uc1698u_config *config,
+		int16_t x, int16_t y, const struct uc1698u_asset *asset);
+
+/* scattered points in any order, sorted by row and column in batches of
+ * UC1698U_GFX_PIXELS_BATCH; each touched tripixel is read-modify-written at
+ * most once per batch and neighbouring ones go out in one burst */
+void uc1698u_write_pixels_64K(struct uc1698u_config *config,
+		const struct uc1698u_point *points, uint16_t count, uint8_t val);
+
+void uc1698u_draw_text_64K(struct uc1698u_config *config,
+		int16_t x, int16_t y, const char *text, uint8_t fg, uint8_t bg);
+
+#endif // UC1698U_GFX_H
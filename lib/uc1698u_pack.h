@@ -0,0 +1,116 @@
+#ifndef UC1698U_PACK_H
+#define UC1698U_PACK_H
+
+/* Compile-time packing of images into 64K colormode wire format
+ *
+ * A source is any type with a constexpr static at(x, y) returning the
+ * shade (0..31) written to the panel at that pixel. uc1698u_pack packs it
+ * row by row into encoded tripixels, padding the last column with shade
+ * 0, and places the result in PROGMEM:
+ *
+ *	struct checker {
+ *		static constexpr uint8_t at(uint16_t x, uint16_t y)
+ *		{
+ *			return ((x / 4 + y / 4) & 1) ? 31 : 0;
+ *		}
+ *	};
+ *
+ *	typedef uc1698u_pack<checker, 24, 24> checker_img;
+ *	uc1698u_write_packed_64K(&config, checker_img::data, 0, 0, 24, 24);
+ *
+ * uc1698u_gray_src adapts a constexpr 8-bit grayscale array (0 black,
+ * 255 white) using the same mapping as extra/convert.
+ *
+ * Only single-return constexpr functions are used, as the AVR core
+ * builds with -std=gnu++11.
+*/
+
+#include "uc1698u.h"
+
+/* index sequence, doubled up so the template depth is log2 of the size */
+
+template <uint16_t... I>
+struct uc1698u_seq {
+	typedef uc1698u_seq type;
+};
+
+template <class A, class B>
+struct uc1698u_seq_cat;
+
+template <uint16_t... A, uint16_t... B>
+struct uc1698u_seq_cat<uc1698u_seq<A...>, uc1698u_seq<B...> >
+	: uc1698u_seq<A..., (uint16_t) (sizeof...(A) + B)...> {};
+
+template <uint16_t N>
+struct uc1698u_make_seq
+	: uc1698u_seq_cat<typename uc1698u_make_seq<N / 2>::type,
+		typename uc1698u_make_seq<N - N / 2>::type> {};
+
+template <>
+struct uc1698u_make_seq<0> : uc1698u_seq<> {};
+
+template <>
+struct uc1698u_make_seq<1> : uc1698u_seq<0> {};
+
+/* sources */
+
+constexpr uint8_t
+uc1698u_gray_to_shade(uint8_t gray)
+{
+	/* white is shade 0, see convert.py */
+	return 31 - (gray >> 3);
+}
+
+template <const uint8_t *Data, uint16_t Width>
+struct uc1698u_gray_src {
+	static constexpr uint8_t at(uint16_t x, uint16_t y)
+	{
+		return uc1698u_gray_to_shade(Data[y * Width + x]);
+	}
+};
+
+/* packing */
+
+template <class Src, uint16_t Width>
+constexpr uint8_t
+uc1698u_pack_pixel(uint16_t x, uint16_t y)
+{
+	return x < Width ? Src::at(x, y) : 0;
+}
+
+/* byte i of the stream, tripixel i / 2 */
+template <class Src, uint16_t Width>
+constexpr uint8_t
+uc1698u_pack_byte(uint16_t i, uint16_t x, uint16_t y)
+{
+	return (i & 1)
+		? uc1698u_64k_encode_b2(uc1698u_pack_pixel<Src, Width>(x, y),
+			uc1698u_pack_pixel<Src, Width>(x + 1, y),
+			uc1698u_pack_pixel<Src, Width>(x + 2, y))
+		: uc1698u_64k_encode_b1(uc1698u_pack_pixel<Src, Width>(x, y),
+			uc1698u_pack_pixel<Src, Width>(x + 1, y),
+			uc1698u_pack_pixel<Src, Width>(x + 2, y));
+}
+
+#define UC1698U_PACK_COLS(width) (((width) + 2) / 3)
+#define UC1698U_PACK_BYTES(width, height) (UC1698U_PACK_COLS(width) * (height) * 2)
+
+template <class Src, uint16_t Width, uint16_t Height,
+	class Seq = typename uc1698u_make_seq<UC1698U_PACK_BYTES(Width, Height)>::type>
+struct uc1698u_pack;
+
+template <class Src, uint16_t Width, uint16_t Height, uint16_t... I>
+struct uc1698u_pack<Src, Width, Height, uc1698u_seq<I...> > {
+	static const uint16_t width = Width;
+	static const uint16_t height = Height;
+	static const uint8_t data[sizeof...(I)];
+};
+
+template <class Src, uint16_t Width, uint16_t Height, uint16_t... I>
+const uint8_t uc1698u_pack<Src, Width, Height, uc1698u_seq<I...> >::data[sizeof...(I)] PROGMEM = {
+	uc1698u_pack_byte<Src, Width>(I,
+		(I / 2) % UC1698U_PACK_COLS(Width) * 3,
+		(I / 2) / UC1698U_PACK_COLS(Width))...
+};
+
+#endif // UC1698U_PACK_H
@@ -0,0 +1,112 @@
+#include "uc1698u_profile.h"
+
+#if UC1698U_PROFILE
+
+#define NAME_LEN 12
+
+struct uc1698u_profile_entry uc1698u_profile[UC1698U_PROF_COUNT];
+
+static const char profile_names[UC1698U_PROF_COUNT][NAME_LEN] PROGMEM = {
+	"init",
+	"disp_enable",
+	"fill_screen",
+	"write_pixel",
+	"write_image",
+	"packed",
+	"test_visual",
+	"span",
+	"line",
+	"draw_rect",
+	"fill_rect",
+	"outside",
+	"draw_circle",
+	"fill_circle",
+	"polygon",
+	"write_row",
+	"write_row_P",
+	"pixels",
+	"draw_image",
+	"text",
+	"anim_frame",
+	"ring_drain",
+	"stream",
+	"scene",
+};
+
+static void
+profile_print_name(uint8_t id)
+{
+	uint8_t i;
+	char c;
+
+	for (i = 0; i < NAME_LEN; i++) {
+		c = pgm_read_byte_near(&profile_names[id][i]);
+		Serial.write(c ? c : ' ');
+	}
+}
+
+void
+uc1698u_profile_record(uint8_t id, uint32_t us)
+{
+	struct uc1698u_profile_entry *entry = &uc1698u_profile[id];
+	uint32_t v;
+	uint8_t bucket;
+
+	/* stop for good before count or sum wrap so the mean stays right */
+	if (entry->full || entry->count == UINT16_MAX || us > UINT32_MAX - entry->sum) {
+		entry->full = 1;
+		return;
+	}
+
+	if (!entry->count || us < entry->min)
+		entry->min = us;
+	if (us > entry->max)
+		entry->max = us;
+	entry->sum += us;
+	entry->count++;
+
+	/* log4 bucket from the bit length */
+	for (bucket = 0, v = us; v; v >>= 1)
+		bucket++;
+	bucket = (bucket + 1) / 2;
+	if (bucket >= UC1698U_PROFILE_BUCKETS)
+		bucket = UC1698U_PROFILE_BUCKETS - 1;
+	entry->hist[bucket]++;
+}
+
+void
+uc1698u_profile_reset(void)
+{
+	memset(uc1698u_profile, 0, sizeof(uc1698u_profile));
+}
+
+void
+uc1698u_profile_report(void)
+{
+	struct uc1698u_profile_entry *entry;
+	uint8_t id, k;
+
+	Serial.print("entry        count min/max/mean uS | hist 0,<4,<16,..,<4^10,>=4^10 uS\n\r");
+	for (id = 0; id < UC1698U_PROF_COUNT; id++) {
+		entry = &uc1698u_profile[id];
+		if (!entry->count)
+			continue;
+
+		profile_print_name(id);
+		Serial.print(entry->count);
+		Serial.print(" ");
+		Serial.print(entry->min);
+		Serial.print("/");
+		Serial.print(entry->max);
+		Serial.print("/");
+		Serial.print(entry->sum / entry->count);
+		Serial.print(" |");
+		for (k = 0; k < UC1698U_PROFILE_BUCKETS; k++) {
+			Serial.print(" ");
+			Serial.print(entry->hist[k]);
+		}
+		Serial.print("\n\r");
+	}
+}
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef UC1698U_PROFILE_H
+#define UC1698U_PROFILE_H
+
+/* On-target timing of the public drawing and init entry points
+ *
+ * Disabled by default and compiled out completely. Enable with the build
+ * flag -DUC1698U_PROFILE=1 (or by changing the default below), then call
+ * uc1698u_profile_report to print min / max / mean and a histogram of
+ * micros() per entry point over Serial.
+ *
+ * Nested entry points are timed on their own as well, e.g. a fill rect
+ * issued by uc1698u_ring_drain shows up under both. An entry stops
+ * recording after 65535 calls or once its total would pass 2^32 uS.
+*/
+
+#include "uc1698u.h"
+
+#ifndef UC1698U_PROFILE
+#define UC1698U_PROFILE 0
+#endif
+
+/* bucket k counts calls taking [4^(k-1), 4^k) uS, the last one is open */
+#define UC1698U_PROFILE_BUCKETS 12
+
+enum {
+	UC1698U_PROF_INIT,
+	UC1698U_PROF_DISPLAY_ENABLE,
+	UC1698U_PROF_FILL_SCREEN,
+	UC1698U_PROF_WRITE_PIXEL,
+	UC1698U_PROF_WRITE_IMAGE,
+	UC1698U_PROF_WRITE_PACKED,
+	UC1698U_PROF_TEST_VISUAL,
+	UC1698U_PROF_SPAN,
+	UC1698U_PROF_LINE,
+	UC1698U_PROF_DRAW_RECT,
+	UC1698U_PROF_FILL_RECT,
+	UC1698U_PROF_OUTSIDE,
+	UC1698U_PROF_DRAW_CIRCLE,
+	UC1698U_PROF_FILL_CIRCLE,
+	UC1698U_PROF_POLYGON,
+	UC1698U_PROF_WRITE_ROW,
+	UC1698U_PROF_WRITE_ROW_P,
+	UC1698U_PROF_PIXELS,
+	UC1698U_PROF_DRAW_IMAGE,
+	UC1698U_PROF_TEXT,
+	UC1698U_PROF_ANIM_FRAME,
+	UC1698U_PROF_RING_DRAIN,
+	UC1698U_PROF_STREAM,
+	UC1698U_PROF_SCENE,
+	UC1698U_PROF_COUNT
+};
+
+#if UC1698U_PROFILE
+
+struct uc1698u_profile_entry {
+	uint32_t min, max, sum;
+	uint16_t count;
+	uint8_t full; /* count or sum would wrap, no longer recording */
+	uint16_t hist[UC1698U_PROFILE_BUCKETS];
+};
+
+extern struct uc1698u_profile_entry uc1698u_profile[UC1698U_PROF_COUNT];
+
+void uc1698u_profile_record(uint8_t id, uint32_t us);
+void uc1698u_profile_reset(void);
+void uc1698u_profile_report(void);
+
+/* times the enclosing scope, including early returns */
+struct uc1698u_profile_scope {
+	uint8_t id;
+	unsigned long start;
+
+	uc1698u_profile_scope(uint8_t id) : id(id), start(micros()) {}
+	~uc1698u_profile_scope() { uc1698u_profile_record(id, micros() - start); }
+};
+
+#define UC1698U_PROFILE_SCOPE(id) struct uc1698u_profile_scope uc1698u_profile_scope_(id)
+
+#else
+
+#define UC1698U_PROFILE_SCOPE(id)
+#define uc1698u_profile_reset()
+#define uc1698u_profile_report()
+
+#endif
+
+#endif // UC1698U_PROFILE_H
@@ -0,0 +1,230 @@
+#include "uc1698u_ring.h"
+#include "uc1698u_profile.h"
+
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+
+#define RING_NEXT(i) (((i) + 1) & (UC1698U_RING_SIZE - 1))
+
+/* keep the compiler from moving the slot write past the index update */
+#define BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+/* helper */
+
+static void
+ring_region(struct uc1698u_ring *ring, const struct uc1698u_draw_cmd *cmd,
+		int16_t *width, int16_t *height)
+{
+	switch (cmd->type) {
+	case UC1698U_DRAW_VALUE:
+		*width = MIN(cmd->width, UC1698U_RING_VALUE_MAX) * UC1698U_FONT_WIDTH;
+		*height = UC1698U_FONT_HEIGHT;
+		break;
+	case UC1698U_DRAW_TEXT:
+		*width = MIN(strlen(cmd->arg.text), UC1698U_GFX_ROW_MAX / UC1698U_FONT_WIDTH)
+			* UC1698U_FONT_WIDTH;
+		*height = UC1698U_FONT_HEIGHT;
+		break;
+	case UC1698U_DRAW_BLIT:
+		if (cmd->arg.asset < ring->asset_count) {
+			*width = ring->assets[cmd->arg.asset].width;
+			*height = ring->assets[cmd->arg.asset].height;
+		} else {
+			*width = *height = 0;
+		}
+		break;
+	default:
+		*width = cmd->width;
+		*height = cmd->height;
+		break;
+	}
+}
+
+static uint8_t
+ring_covered(struct uc1698u_ring *ring, uint8_t i, uint8_t head)
+{
+	const struct uc1698u_draw_cmd *a, *b;
+	int16_t aw, ah, bw, bh;
+	uint8_t j;
+
+	a = &ring->cmds[i];
+	ring_region(ring, a, &aw, &ah);
+
+	/* every command draws its region opaque, so a later one covering
+	 * it completely makes it redundant */
+	for (j = RING_NEXT(i); j != head; j = RING_NEXT(j)) {
+		b = &ring->cmds[j];
+		ring_region(ring, b, &bw, &bh);
+		if (b->x <= a->x && b->y <= a->y && b->x + bw >= a->x + aw
+				&& b->y + bh >= a->y + ah)
+			return 1;
+	}
+
+	return 0;
+}
+
+static void
+ring_format(char *buf, uint8_t width, int16_t value)
+{
+	uint16_t mag;
+	uint8_t i;
+
+	i = MIN(width, UC1698U_RING_VALUE_MAX);
+	buf[i] = '\0';
+	if (!i)
+		return;
+
+	mag = (value < 0) ? -(int32_t) value : value;
+	do {
+		buf[--i] = '0' + mag % 10;
+		mag /= 10;
+	} while (mag && i);
+
+	if (mag || (value < 0 && !i)) {
+		/* does not fit */
+		memset(buf, '#', MIN(width, UC1698U_RING_VALUE_MAX));
+		return;
+	}
+
+	if (value < 0)
+		buf[--i] = '-';
+	while (i)
+		buf[--i] = ' ';
+}
+
+static void
+ring_draw(struct uc1698u_config *config, struct uc1698u_ring *ring,
+		const struct uc1698u_draw_cmd *cmd)
+{
+	char buf[UC1698U_RING_VALUE_MAX + 1];
+
+	switch (cmd->type) {
+	case UC1698U_DRAW_VALUE:
+		ring_format(buf, cmd->width, cmd->arg.value);
+		uc1698u_draw_text_64K(config, cmd->x, cmd->y, buf, cmd->fg, cmd->bg);
+		break;
+	case UC1698U_DRAW_FILL:
+		uc1698u_fill_rect_64K(config, cmd->x, cmd->y, cmd->width, cmd->height, cmd->fg);
+		break;
+	case UC1698U_DRAW_TEXT:
+		uc1698u_draw_text_64K(config, cmd->x, cmd->y, cmd->arg.text, cmd->fg, cmd->bg);
+		break;
+	case UC1698U_DRAW_BLIT:
+		if (cmd->arg.asset < ring->asset_count)
+			uc1698u_draw_image_64K(config, cmd->x, cmd->y, &ring->assets[cmd->arg.asset]);
+		break;
+	}
+}
+
+/* producer */
+
+void
+uc1698u_ring_init(struct uc1698u_ring *ring,
+		const struct uc1698u_asset *assets, uint8_t asset_count)
+{
+	ring->head = ring->tail = 0;
+	ring->dropped = 0;
+	ring->assets = assets;
+	ring->asset_count = asset_count;
+}
+
+uint8_t
+uc1698u_ring_push(struct uc1698u_ring *ring, const struct uc1698u_draw_cmd *cmd)
+{
+	uint8_t head = ring->head;
+
+	if (RING_NEXT(head) == ring->tail) {
+		ring->dropped++;
+		return 0;
+	}
+
+	ring->cmds[head] = *cmd;
+	BARRIER();
+	ring->head = RING_NEXT(head);
+
+	return 1;
+}
+
+uint8_t
+uc1698u_ring_push_value(struct uc1698u_ring *ring, uint8_t x, uint8_t y,
+		uint8_t width, int16_t value, uint8_t fg, uint8_t bg)
+{
+	struct uc1698u_draw_cmd cmd;
+
+	cmd.type = UC1698U_DRAW_VALUE;
+	cmd.x = x;
+	cmd.y = y;
+	cmd.width = MIN(width, UC1698U_RING_VALUE_MAX);
+	cmd.fg = fg;
+	cmd.bg = bg;
+	cmd.arg.value = value;
+
+	return uc1698u_ring_push(ring, &cmd);
+}
+
+uint8_t
+uc1698u_ring_push_fill(struct uc1698u_ring *ring, uint8_t x, uint8_t y,
+		uint8_t width, uint8_t height, uint8_t val)
+{
+	struct uc1698u_draw_cmd cmd;
+
+	cmd.type = UC1698U_DRAW_FILL;
+	cmd.x = x;
+	cmd.y = y;
+	cmd.width = width;
+	cmd.height = height;
+	cmd.fg = val;
+
+	return uc1698u_ring_push(ring, &cmd);
+}
+
+uint8_t
+uc1698u_ring_push_text(struct uc1698u_ring *ring, uint8_t x, uint8_t y,
+		const char *text, uint8_t fg, uint8_t bg)
+{
+	struct uc1698u_draw_cmd cmd;
+
+	cmd.type = UC1698U_DRAW_TEXT;
+	cmd.x = x;
+	cmd.y = y;
+	cmd.fg = fg;
+	cmd.bg = bg;
+	cmd.arg.text = text;
+
+	return uc1698u_ring_push(ring, &cmd);
+}
+
+uint8_t
+uc1698u_ring_push_blit(struct uc1698u_ring *ring, uint8_t x, uint8_t y, uint8_t asset)
+{
+	struct uc1698u_draw_cmd cmd;
+
+	cmd.type = UC1698U_DRAW_BLIT;
+	cmd.x = x;
+	cmd.y = y;
+	cmd.arg.asset = asset;
+
+	return uc1698u_ring_push(ring, &cmd);
+}
+
+/* consumer */
+
+uint8_t
+uc1698u_ring_drain(struct uc1698u_config *config, struct uc1698u_ring *ring)
+{
+	uint8_t i, head, drawn = 0;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_RING_DRAIN);
+
+	/* commands pushed while draining wait for the next call */
+	head = ring->head;
+	BARRIER();
+
+	for (i = ring->tail; i != head; i = RING_NEXT(i)) {
+		if (!ring_covered(ring, i, head)) {
+			ring_draw(config, ring, &ring->cmds[i]);
+			drawn++;
+		}
+		ring->tail = RING_NEXT(i);
+	}
+
+	return drawn;
+}
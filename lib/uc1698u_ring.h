@@ -0,0 +1,66 @@
+#ifndef UC1698U_RING_H
+#define UC1698U_RING_H
+
+/* Draw command ring between interrupt handlers and the renderer
+ *
+ * uc1698u_write is not reentrant, so ISRs never touch the bus. They push
+ * compact commands into a single-producer / single-consumer ring, which
+ * takes constant time and never blocks (a full ring drops the command).
+ * The main loop calls uc1698u_ring_drain, which skips every queued
+ * command whose region is fully covered by a later one before drawing.
+ *
+ * Only one context may push (e.g. ISRs that do not nest) and only one
+ * may drain.
+*/
+
+#include "uc1698u.h"
+#include "uc1698u_gfx.h"
+
+/* must be a power of two */
+#define UC1698U_RING_SIZE 16
+
+/* max characters of a value, wider fields are clamped to it */
+#define UC1698U_RING_VALUE_MAX 7
+
+enum {
+	UC1698U_DRAW_VALUE, /* number right aligned in 'width' characters, at most
+	                     * UC1698U_RING_VALUE_MAX */
+	UC1698U_DRAW_FILL,
+	UC1698U_DRAW_TEXT,  /* text must stay valid until drained */
+	UC1698U_DRAW_BLIT,  /* asset from the table passed on init */
+};
+
+struct uc1698u_draw_cmd {
+	uint8_t type, x, y, width, height, fg, bg;
+	union {
+		int16_t value;
+		const char *text;
+		uint8_t asset;
+	} arg;
+};
+
+struct uc1698u_ring {
+	struct uc1698u_draw_cmd cmds[UC1698U_RING_SIZE];
+	volatile uint8_t head, tail;
+	volatile uint8_t dropped; /* commands lost to a full ring */
+	const struct uc1698u_asset *assets;
+	uint8_t asset_count;
+};
+
+void uc1698u_ring_init(struct uc1698u_ring *ring,
+		const struct uc1698u_asset *assets, uint8_t asset_count);
+
+/* producer side, safe from ISRs, return 0 if the ring was full */
+uint8_t uc1698u_ring_push(struct uc1698u_ring *ring, const struct uc1698u_draw_cmd *cmd);
+uint8_t uc1698u_ring_push_value(struct uc1698u_ring *ring, uint8_t x, uint8_t y,
+		uint8_t width, int16_t value, uint8_t fg, uint8_t bg);
+uint8_t uc1698u_ring_push_fill(struct uc1698u_ring *ring, uint8_t x, uint8_t y,
+		uint8_t width, uint8_t height, uint8_t val);
+uint8_t uc1698u_ring_push_text(struct uc1698u_ring *ring, uint8_t x, uint8_t y,
+		const char *text, uint8_t fg, uint8_t bg);
+uint8_t uc1698u_ring_push_blit(struct uc1698u_ring *ring, uint8_t x, uint8_t y, uint8_t asset);
+
+/* consumer side, returns the number of commands drawn */
+uint8_t uc1698u_ring_drain(struct uc1698u_config *config, struct uc1698u_ring *ring);
+
+#endif // UC1698U_RING_H
@@ -0,0 +1,291 @@
+#include "uc1698u_scene.h"
+#include "uc1698u_profile.h"
+
+#define MAX(a,b) ((a) > (b) ? (a) : (b))
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+#define BIT(v,n) (((v) >> (n)) & 1)
+
+/* helper */
+
+static void
+scene_mark(struct uc1698u_scene *scene, uint8_t y, uint8_t height)
+{
+	if (!height)
+		return;
+	scene->dirty_top = MIN(scene->dirty_top, y);
+	scene->dirty_bot = MAX(scene->dirty_bot, MIN(y + height - 1, 0xff));
+}
+
+static int8_t
+scene_add(struct uc1698u_scene *scene, uint8_t type, uint8_t x, uint8_t y,
+		uint8_t width, uint8_t height)
+{
+	struct uc1698u_widget *w;
+
+	if (scene->count == UC1698U_SCENE_WIDGETS)
+		return -1;
+
+	w = &scene->widgets[scene->count];
+	memset(w, 0, sizeof(*w));
+	w->type = type;
+	w->x = x;
+	w->y = y;
+	w->width = width;
+	w->height = height;
+	scene_mark(scene, y, height);
+
+	return scene->count++;
+}
+
+/* set one pixel of an encoded row, same bit layout as uc1698u_64k_encode */
+static void
+scene_put(uint8_t *row, int16_t width, int16_t x, uint8_t val)
+{
+	uint8_t *t;
+
+	if (x < 0 || x >= width)
+		return;
+
+	t = row + (x / 3) * 2;
+	switch (x % 3) {
+	case 0:
+		t[0] = (t[0] & 0x07) | ((val & 0x1f) << 3);
+		break;
+	case 1:
+		t[0] = (t[0] & 0xf8) | ((val >> 2) & 0x07);
+		t[1] = (t[1] & 0x3f) | ((val & 0x03) << 6);
+		break;
+	case 2:
+		t[1] = (t[1] & 0xc0) | (val & 0x1f);
+		break;
+	}
+}
+
+static void
+scene_run(uint8_t *row, int16_t width, int16_t x0, int16_t x1, uint8_t val)
+{
+	uint8_t b1, b2;
+
+	x0 = MAX(x0, 0);
+	x1 = MIN(x1, width - 1);
+
+	while (x0 <= x1 && x0 % 3 != 0)
+		scene_put(row, width, x0++, val);
+
+	uc1698u_64k_encode(&b1, &b2, val, val, val);
+	for (; x0 + 2 <= x1; x0 += 3) {
+		row[(x0 / 3) * 2 + 0] = b1;
+		row[(x0 / 3) * 2 + 1] = b2;
+	}
+
+	while (x0 <= x1)
+		scene_put(row, width, x0++, val);
+}
+
+static void
+scene_row(struct uc1698u_scene *scene, uint8_t *row, int16_t width, uint8_t y)
+{
+	const struct uc1698u_widget *w;
+	const uint8_t *glyph;
+	uint8_t i, k, r, ch, bits;
+	uint16_t split;
+
+	scene_run(row, width, 0, width - 1, scene->bg);
+
+	for (i = 0; i < scene->count; i++) {
+		w = &scene->widgets[i];
+		if (y < w->y || y >= w->y + w->height)
+			continue;
+		r = y - w->y;
+
+		switch (w->type) {
+		case UC1698U_WIDGET_RECT:
+			scene_run(row, width, w->x, w->x + w->width - 1, w->fg);
+			break;
+		case UC1698U_WIDGET_BAR:
+			split = (uint16_t) w->width * w->value / 255;
+			scene_run(row, width, w->x, w->x + split - 1, w->fg);
+			scene_run(row, width, w->x + split, w->x + w->width - 1, w->bg);
+			break;
+		case UC1698U_WIDGET_TEXT:
+			for (k = 0; k < w->width; k++) {
+				ch = w->arg.text[k / UC1698U_FONT_WIDTH];
+				if (ch < 0x20 || ch > 0x7e)
+					ch = '?';
+				glyph = uc1698u_font + (ch - 0x20) * 5;
+				bits = (k % UC1698U_FONT_WIDTH < 5)
+					? pgm_read_byte_near(glyph + k % UC1698U_FONT_WIDTH) : 0;
+				if (BIT(bits, r))
+					scene_put(row, width, w->x + k, w->fg);
+				else if (w->bg != UC1698U_SCENE_CLEAR)
+					scene_put(row, width, w->x + k, w->bg);
+			}
+			break;
+		case UC1698U_WIDGET_BITMAP:
+			for (k = 0; k < w->width; k++) {
+				scene_put(row, width, w->x + k, pgm_read_byte_near(w->arg.asset->data
+						+ (uint16_t) r * w->width + k));
+			}
+			break;
+		}
+	}
+}
+
+/* widgets */
+
+void
+uc1698u_scene_init(struct uc1698u_scene *scene, uint8_t bg)
+{
+	scene->count = 0;
+	scene->bg = bg;
+	uc1698u_scene_invalidate(scene, 0, 0xff);
+}
+
+int8_t
+uc1698u_scene_add_rect(struct uc1698u_scene *scene, uint8_t x, uint8_t y,
+		uint8_t width, uint8_t height, uint8_t fg)
+{
+	int8_t id;
+
+	id = scene_add(scene, UC1698U_WIDGET_RECT, x, y, width, height);
+	if (id >= 0)
+		scene->widgets[id].fg = fg;
+
+	return id;
+}
+
+int8_t
+uc1698u_scene_add_text(struct uc1698u_scene *scene, uint8_t x, uint8_t y,
+		const char *text, uint8_t fg, uint8_t bg)
+{
+	int8_t id;
+
+	id = scene_add(scene, UC1698U_WIDGET_TEXT, x, y,
+			MIN(strlen(text), 0xff / UC1698U_FONT_WIDTH) * UC1698U_FONT_WIDTH,
+			UC1698U_FONT_HEIGHT);
+	if (id >= 0) {
+		scene->widgets[id].fg = fg;
+		scene->widgets[id].bg = bg;
+		scene->widgets[id].arg.text = text;
+	}
+
+	return id;
+}
+
+int8_t
+uc1698u_scene_add_bitmap(struct uc1698u_scene *scene, uint8_t x, uint8_t y,
+		const struct uc1698u_asset *asset)
+{
+	int8_t id;
+
+	id = scene_add(scene, UC1698U_WIDGET_BITMAP, x, y, asset->width, asset->height);
+	if (id >= 0)
+		scene->widgets[id].arg.asset = asset;
+
+	return id;
+}
+
+int8_t
+uc1698u_scene_add_bar(struct uc1698u_scene *scene, uint8_t x, uint8_t y,
+		uint8_t width, uint8_t height, uint8_t fg, uint8_t bg, uint8_t value)
+{
+	int8_t id;
+
+	id = scene_add(scene, UC1698U_WIDGET_BAR, x, y, width, height);
+	if (id >= 0) {
+		scene->widgets[id].fg = fg;
+		scene->widgets[id].bg = bg;
+		scene->widgets[id].value = value;
+	}
+
+	return id;
+}
+
+void
+uc1698u_scene_set_value(struct uc1698u_scene *scene, int8_t id, uint8_t value)
+{
+	struct uc1698u_widget *w;
+
+	if (id < 0 || id >= scene->count)
+		return;
+	w = &scene->widgets[id];
+	if (w->value == value)
+		return;
+	w->value = value;
+	scene_mark(scene, w->y, w->height);
+}
+
+void
+uc1698u_scene_set_text(struct uc1698u_scene *scene, int8_t id, const char *text)
+{
+	struct uc1698u_widget *w;
+
+	if (id < 0 || id >= scene->count)
+		return;
+	w = &scene->widgets[id];
+	w->arg.text = text;
+	w->width = MIN(strlen(text), 0xff / UC1698U_FONT_WIDTH) * UC1698U_FONT_WIDTH;
+	scene_mark(scene, w->y, w->height);
+}
+
+void
+uc1698u_scene_move(struct uc1698u_scene *scene, int8_t id, uint8_t x, uint8_t y)
+{
+	struct uc1698u_widget *w;
+
+	if (id < 0 || id >= scene->count)
+		return;
+	w = &scene->widgets[id];
+	scene_mark(scene, w->y, w->height);
+	w->x = x;
+	w->y = y;
+	scene_mark(scene, w->y, w->height);
+}
+
+void
+uc1698u_scene_invalidate(struct uc1698u_scene *scene, uint8_t top, uint8_t bot)
+{
+	scene->dirty_top = top;
+	scene->dirty_bot = bot;
+}
+
+/* render */
+
+void
+uc1698u_scene_render(struct uc1698u_config *config, struct uc1698u_scene *scene)
+{
+	uint8_t sc, sr, ec, er, cols, rows, r, narrow;
+	int16_t y, bot, width;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_SCENE);
+
+	if (scene->dirty_top > scene->dirty_bot)
+		return;
+
+	sc = config->state.window_prog_start_col;
+	sr = config->state.window_prog_start_row;
+	ec = config->state.window_prog_end_col;
+	er = config->state.window_prog_end_row;
+	cols = MIN(ec - sc + 1, UC1698U_GFX_ROW_MAX / 3);
+	narrow = (cols != ec - sc + 1);
+	width = cols * 3;
+	bot = MIN(scene->dirty_bot, er - sr);
+
+	/* the write wraps into the next row at the window edge, so a window
+	 * wider than the band needs one exactly as wide around each band */
+	for (y = scene->dirty_top; y <= bot; y += rows) {
+		rows = MIN(UC1698U_SCENE_BAND_ROWS, bot - y + 1);
+		for (r = 0; r < rows; r++)
+			scene_row(scene, scene->band + r * cols * 2, width, y + r);
+
+		if (narrow)
+			uc1698u_set_window(config, sc, sr + y, sc + cols - 1, sr + y + rows - 1);
+		uc1698u_set_col_address(config, sc);
+		uc1698u_set_row_address(config, sr + y);
+		uc1698u_write_buf(config, UC1698U_DATA, scene->band, rows * cols * 2);
+	}
+	if (narrow)
+		uc1698u_set_window(config, sc, sr, ec, er);
+
+	scene->dirty_top = 0xff;
+	scene->dirty_bot = 0;
+}
@@ -0,0 +1,69 @@
+#ifndef UC1698U_SCENE_H
+#define UC1698U_SCENE_H
+
+/* Retained-mode scene renderer for 64K colormode
+ *
+ * Widgets are kept in a small display list and drawn in list order, later
+ * ones on top. Rendering rasterises the list band by band straight into
+ * an encoded band buffer (108 bytes per row on the ERC160160) and streams
+ * each band with one burst, so overlapping UIs cost constant RAM and no
+ * reads from the display. Only rows touched since the last render are
+ * redrawn.
+ *
+ * Coordinates are pixels relative to the window set up on init.
+*/
+
+#include "uc1698u.h"
+#include "uc1698u_gfx.h"
+
+#define UC1698U_SCENE_WIDGETS 16
+#define UC1698U_SCENE_BAND_ROWS 2
+#define UC1698U_SCENE_BAND_BYTES (UC1698U_SCENE_BAND_ROWS * UC1698U_GFX_ROW_MAX / 3 * 2)
+
+/* text background that keeps what is below */
+#define UC1698U_SCENE_CLEAR 0xff
+
+enum {
+	UC1698U_WIDGET_RECT,   /* filled with fg */
+	UC1698U_WIDGET_TEXT,   /* fg on bg, bg may be UC1698U_SCENE_CLEAR */
+	UC1698U_WIDGET_BITMAP,
+	UC1698U_WIDGET_BAR,    /* horizontal, value / 255 of the width in fg, rest in bg */
+};
+
+struct uc1698u_widget {
+	uint8_t type, x, y, width, height, fg, bg, value;
+	union {
+		const char *text;
+		const struct uc1698u_asset *asset;
+	} arg;
+};
+
+struct uc1698u_scene {
+	struct uc1698u_widget widgets[UC1698U_SCENE_WIDGETS];
+	uint8_t count, bg;
+	uint8_t dirty_top, dirty_bot; /* rows to redraw, top > bot if none */
+	uint8_t band[UC1698U_SCENE_BAND_BYTES];
+};
+
+void uc1698u_scene_init(struct uc1698u_scene *scene, uint8_t bg);
+
+/* return the widget id, or -1 if the list is full */
+int8_t uc1698u_scene_add_rect(struct uc1698u_scene *scene, uint8_t x, uint8_t y,
+		uint8_t width, uint8_t height, uint8_t fg);
+int8_t uc1698u_scene_add_text(struct uc1698u_scene *scene, uint8_t x, uint8_t y,
+		const char *text, uint8_t fg, uint8_t bg);
+int8_t uc1698u_scene_add_bitmap(struct uc1698u_scene *scene, uint8_t x, uint8_t y,
+		const struct uc1698u_asset *asset);
+int8_t uc1698u_scene_add_bar(struct uc1698u_scene *scene, uint8_t x, uint8_t y,
+		uint8_t width, uint8_t height, uint8_t fg, uint8_t bg, uint8_t value);
+
+/* changes only mark the affected rows, nothing is drawn until render,
+ * ids that were never returned (like -1 from a full list) are ignored */
+void uc1698u_scene_set_value(struct uc1698u_scene *scene, int8_t id, uint8_t value);
+void uc1698u_scene_set_text(struct uc1698u_scene *scene, int8_t id, const char *text);
+void uc1698u_scene_move(struct uc1698u_scene *scene, int8_t id, uint8_t x, uint8_t y);
+void uc1698u_scene_invalidate(struct uc1698u_scene *scene, uint8_t top, uint8_t bot);
+
+void uc1698u_scene_render(struct uc1698u_config *config, struct uc1698u_scene *scene);
+
+#endif // UC1698U_SCENE_H
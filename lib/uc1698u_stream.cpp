@@ -0,0 +1,174 @@
+#include "uc1698u_stream.h"
+#include "uc1698u_profile.h"
+
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+
+enum {
+	STREAM_SYNC,
+	STREAM_OP,
+	STREAM_HEADER,
+	STREAM_CHUNK,
+	STREAM_LITERAL_B1,
+	STREAM_LITERAL_B2,
+	STREAM_RUN_B1,
+	STREAM_RUN_B2
+};
+
+/* helper */
+
+static void
+stream_rect_begin(struct uc1698u_config *config, struct uc1698u_stream *stream)
+{
+	uint8_t col, row, width, height;
+
+	col = stream->hdr[0];
+	row = stream->hdr[1];
+	width = stream->hdr[2];
+	height = stream->hdr[3];
+
+	if (!width || !height || col + width > stream->ec - stream->sc + 1
+			|| row + height > stream->er - stream->sr + 1) {
+		stream->errors++;
+		stream->state = STREAM_SYNC;
+		return;
+	}
+
+	uc1698u_set_window(config, stream->sc + col, stream->sr + row,
+			stream->sc + col + width - 1, stream->sr + row + height - 1);
+	uc1698u_set_col_address(config, stream->sc + col);
+	uc1698u_set_row_address(config, stream->sr + row);
+
+	stream->left = (uint16_t) width * height;
+	stream->state = STREAM_CHUNK;
+}
+
+static void
+stream_chunk_done(struct uc1698u_config *config, struct uc1698u_stream *stream)
+{
+	if (stream->count) {
+		stream->state = STREAM_LITERAL_B1;
+		return;
+	}
+	if (stream->left) {
+		stream->state = STREAM_CHUNK;
+		return;
+	}
+
+	uc1698u_set_window(config, stream->sc, stream->sr, stream->ec, stream->er);
+	stream->state = STREAM_SYNC;
+}
+
+/* receiver */
+
+void
+uc1698u_stream_init(struct uc1698u_config *config, struct uc1698u_stream *stream)
+{
+	memset(stream, 0, sizeof(*stream));
+	stream->state = STREAM_SYNC;
+	stream->sc = config->state.window_prog_start_col;
+	stream->sr = config->state.window_prog_start_row;
+	stream->ec = config->state.window_prog_end_col;
+	stream->er = config->state.window_prog_end_row;
+}
+
+uint8_t
+uc1698u_stream_feed(struct uc1698u_config *config, struct uc1698u_stream *stream,
+		uint8_t val)
+{
+	switch (stream->state) {
+	case STREAM_SYNC:
+		if (val == UC1698U_STREAM_SYNC)
+			stream->state = STREAM_OP;
+		else
+			stream->errors++;
+		break;
+	case STREAM_OP:
+		stream->op = val;
+		stream->state = STREAM_SYNC;
+		switch (val) {
+		case 'H':
+			return UC1698U_STREAM_HELLO;
+		case 'F':
+			stream->frames++;
+			return UC1698U_STREAM_FRAME;
+		case 'R':
+			stream->hdr_len = 0;
+			stream->state = STREAM_HEADER;
+			break;
+		default:
+			stream->errors++;
+			break;
+		}
+		break;
+	case STREAM_HEADER:
+		stream->hdr[stream->hdr_len++] = val;
+		if (stream->hdr_len == sizeof(stream->hdr))
+			stream_rect_begin(config, stream);
+		break;
+	case STREAM_CHUNK:
+		/* chunks never run past the rect, the window would wrap */
+		if (val & UC1698U_STREAM_RUN) {
+			stream->count = MIN((val & 0x7f) + 1, stream->left);
+			stream->state = STREAM_RUN_B1;
+		} else {
+			stream->count = MIN(val + 1, stream->left);
+			stream->state = STREAM_LITERAL_B1;
+			/* CS stays low until the last tripixel of the chunk arrives */
+			uc1698u_write_begin(config, UC1698U_DATA);
+		}
+		stream->left -= stream->count;
+		break;
+	case STREAM_LITERAL_B1:
+		uc1698u_write_byte(config, val);
+		stream->state = STREAM_LITERAL_B2;
+		break;
+	case STREAM_LITERAL_B2:
+		uc1698u_write_byte(config, val);
+		if (!--stream->count)
+			uc1698u_write_end(config);
+		stream_chunk_done(config, stream);
+		break;
+	case STREAM_RUN_B1:
+		stream->b1 = val;
+		stream->state = STREAM_RUN_B2;
+		break;
+	case STREAM_RUN_B2:
+		uc1698u_write_repeat(config, UC1698U_DATA, stream->b1, val, stream->count);
+		stream->count = 0;
+		stream_chunk_done(config, stream);
+		break;
+	}
+
+	return UC1698U_STREAM_NONE;
+}
+
+uint8_t
+uc1698u_stream_poll(struct uc1698u_config *config, struct uc1698u_stream *stream,
+		Stream *io)
+{
+	uint8_t done = 0;
+	UC1698U_PROFILE_SCOPE(UC1698U_PROF_STREAM);
+
+	while (io->available() > 0) {
+		switch (uc1698u_stream_feed(config, stream, io->read())) {
+		case UC1698U_STREAM_HELLO:
+			io->write('H');
+			io->write(stream->ec - stream->sc + 1);
+			io->write(stream->er - stream->sr + 1);
+			/* the host counts credits from here */
+			stream->consumed = 0;
+			continue;
+		case UC1698U_STREAM_FRAME:
+			io->write('F');
+			done = 1;
+			break;
+		}
+
+		if (++stream->consumed == UC1698U_STREAM_CREDIT) {
+			stream->consumed = 0;
+			io->write('K');
+		}
+	}
+
+	return done;
+}
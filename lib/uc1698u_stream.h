@@ -0,0 +1,66 @@
+#ifndef UC1698U_STREAM_H
+#define UC1698U_STREAM_H
+
+/* Framebuffer streaming from a host over a serial link in 64K colormode
+ *
+ * The host (extra/stream/stream.py) keeps the previous frame and only
+ * sends the rects of tripixels that changed, run-length coded. Every
+ * message starts with UC1698U_STREAM_SYNC and an op:
+ *
+ *	'H'                         hello, answered with 'H', columns, rows
+ *	'R' col row width height    rect in tripixels relative to the window,
+ *	                            chunks follow until it is complete
+ *	'F'                         end of frame, answered with 'F'
+ *
+ * A chunk header h < 0x80 is followed by h + 1 literal tripixels, any
+ * other by one tripixel repeated (h & 0x7f) + 1 times. Tripixels are two
+ * bytes as from uc1698u_64k_encode.
+ *
+ * Nothing is buffered, rect data goes to the panel as it arrives through
+ * a window around the rect, so do not draw between a rect header and its
+ * last chunk. A literal chunk keeps CS low from its header to its last
+ * tripixel. For flow control 'K' is answered for every
+ * UC1698U_STREAM_CREDIT bytes consumed and the host keeps at most
+ * UC1698U_STREAM_WINDOW bytes unanswered, which fits the 64 byte serial
+ * receive buffer however long the panel writes take.
+*/
+
+#include "uc1698u.h"
+
+#define UC1698U_STREAM_SYNC 0xa5
+#define UC1698U_STREAM_CREDIT 16
+#define UC1698U_STREAM_WINDOW 48
+
+/* chunk headers */
+#define UC1698U_STREAM_RUN 0x80
+#define UC1698U_STREAM_CHUNK_MAX 128
+
+enum {
+	UC1698U_STREAM_NONE,
+	UC1698U_STREAM_HELLO,
+	UC1698U_STREAM_FRAME
+};
+
+struct uc1698u_stream {
+	uint8_t state, op, b1;
+	uint8_t hdr[4], hdr_len;
+	uint8_t count;      /* tripixels left in the chunk */
+	uint16_t left;      /* tripixels left in the rect */
+	uint8_t consumed;   /* bytes since the last credit */
+	uint8_t sc, sr, ec, er; /* window to stream into */
+	uint16_t frames, errors;
+};
+
+/* takes the current window of config */
+void uc1698u_stream_init(struct uc1698u_config *config, struct uc1698u_stream *stream);
+
+/* one received byte, returns one of the events above */
+uint8_t uc1698u_stream_feed(struct uc1698u_config *config, struct uc1698u_stream *stream,
+		uint8_t val);
+
+/* feed everything available from io and send the replies,
+ * returns 1 if a frame was completed */
+uint8_t uc1698u_stream_poll(struct uc1698u_config *config, struct uc1698u_stream *stream,
+		Stream *io);
+
+#endif // UC1698U_STREAM_H